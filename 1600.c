@@ -24,48 +24,38 @@ static const uint64_t rc64[] = {
 #define rotate64(x, n) ((uint64_t)(((uint64_t)(x) >> (64L - (n))) | ((uint64_t)(x) << (n))))
 
 
+#if !BIT_INTERLEAVED_1600
+
+
 /**
- * 64-bit word version of `libkeccak_f_round`
+ * 64-bit word version of `libkeccak_f`
  * 
  * @param  state  The hashing state
- * @param  rc     The round contant for this round
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
 static void
-libkeccak_f_round64(register struct libkeccak_state *state, register uint64_t rc)
+libkeccak_f64(register struct libkeccak_state *state)
 {
-	uint64_t *restrict A = state->S.w64;
-	uint64_t B[25], C[5], da, db, dc, dd, de;
+	KECCAK_F(state->S.w64, uint64_t, state->nr, &rc64[24 - state->nr], rotate64, CHI_DEFAULT);
+}
 
-	/* θ step (step 1 of 3). */
-#define X(N) C[N] = A[N * 5] ^ A[N * 5 + 1] ^ A[N * 5 + 2] ^ A[N * 5 + 3] ^ A[N * 5 + 4]
-	LIST_5(X, ;);
-#undef X
 
-	/* θ step (step 2 of 3). */
-	da = C[4] ^ rotate64(C[1], 1);
-	dd = C[2] ^ rotate64(C[4], 1);
-	db = C[0] ^ rotate64(C[2], 1);
-	de = C[3] ^ rotate64(C[0], 1);
-	dc = C[1] ^ rotate64(C[3], 1);
-
-	/* ρ and π steps, with last two part of θ. */
-#define X(bi, ai, dv, r) B[bi] = rotate64(A[ai] ^ dv, r)
-	B[0] = A[0] ^ da;   X( 1, 15, dd, 28);  X( 2,  5, db,  1);  X( 3, 20, de, 27);  X( 4, 10, dc, 62);
-	X( 5,  6, db, 44);  X( 6, 21, de, 20);  X( 7, 11, dc,  6);  X( 8,  1, da, 36);  X( 9, 16, dd, 55);
-	X(10, 12, dc, 43);  X(11,  2, da,  3);  X(12, 17, dd, 25);  X(13,  7, db, 10);  X(14, 22, de, 39);
-	X(15, 18, dd, 21);  X(16,  8, db, 45);  X(17, 23, de,  8);  X(18, 13, dc, 15);  X(19,  3, da, 41);
-	X(20, 24, de, 14);  X(21, 14, dc, 61);  X(22,  4, da, 18);  X(23, 19, dd, 56);  X(24,  9, db,  2);
-#undef X
+# if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_f64` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_f64_bmi(register struct libkeccak_state *state)
+{
+	KECCAK_F(state->S.w64, uint64_t, state->nr, &rc64[24 - state->nr], rotate64, ANDN);
+}
+# endif
 
-	/* ξ step. */
-#define X(N) A[N] = B[N] ^ ((~(B[(N + 5) % 25])) & B[(N + 10) % 25])
-	LIST_25(X, ;);
-#undef X
 
-	/* ι step. */
-	A[0] ^= rc;
-}
+#endif
 
 
 /**
@@ -90,3 +80,686 @@ libkeccak_to_lane64(register const unsigned char *message, register size_t msgle
 #undef X
 	return rc;
 }
+
+
+/**
+ * Read a 64-bit lane stored in little endian,
+ * the lane does not need to be aligned
+ * 
+ * @param   message  The lane's location in the message
+ * @return           The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint64_t
+libkeccak_load64(register const unsigned char *message)
+{
+#if defined(HOST_LITTLE_ENDIAN)
+	uint64_t rc;
+	__builtin_memcpy(&rc, message, sizeof(rc));
+	return rc;
+#elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	uint64_t rc;
+	__builtin_memcpy(&rc, message, sizeof(rc));
+	return __builtin_bswap64(rc);
+#else
+	uint64_t rc = 0;
+# define X(N) rc |= (uint64_t)message[N] << (N * 8)
+	LIST_8(X, ;);
+# undef X
+	return rc;
+#endif
+}
+
+
+/**
+ * 64-bit lane version of `libkeccak_absorb_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  message  The block to absorb, must be at least `rr` bytes
+ * @param  rr       Bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_absorb_block64(register uint64_t *restrict S, register const unsigned char *restrict message, register long int rr)
+{
+	register long int i, n = rr >> 3;
+	for (i = 0; i < n; i++)
+		S[i] ^= libkeccak_load64(&message[i * 8]);
+	if (rr & 7)
+		S[n] ^= libkeccak_to_lane64(message, (size_t)rr, rr, (size_t)(n * 8));
+}
+
+
+/**
+ * Store a 64-bit lane in little endian,
+ * the lane does not need to be aligned
+ * 
+ * @param  message  The lane's location in the output
+ * @param  value    The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_store64(register unsigned char *message, uint64_t value)
+{
+#if defined(HOST_LITTLE_ENDIAN)
+	__builtin_memcpy(message, &value, sizeof(value));
+#elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	value = __builtin_bswap64(value);
+	__builtin_memcpy(message, &value, sizeof(value));
+#else
+# define X(N) message[N] = (unsigned char)(value >> (N * 8))
+	LIST_8(X, ;);
+# undef X
+#endif
+}
+
+
+/**
+ * 64-bit lane version of `libkeccak_squeeze_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_squeeze_block64(register const uint64_t *restrict S, register unsigned char *restrict hashsum, register long int len)
+{
+	register long int i, n = len / 8;
+	register uint64_t v;
+	for (i = 0; i < n; i++)
+		libkeccak_store64(&hashsum[i * 8], S[i]);
+	hashsum += n * 8;
+	len -= n * 8;
+	for (v = S[n]; len--; v >>= 8)
+		*hashsum++ = (unsigned char)v;
+}
+
+
+#if !BIT_INTERLEAVED_1600
+
+
+/**
+ * Absorb whole blocks into a sponge with 64-bit lanes,
+ * and permute the sponge after each block
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb64(register struct libkeccak_state *restrict state,
+                   register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block64(state->S.w64, message, rr);
+		KECCAK_F(state->S.w64, uint64_t, state->nr, &rc64[24 - state->nr], rotate64, CHI_DEFAULT);
+	}
+}
+
+
+# if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_absorb64` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_absorb64_bmi(register struct libkeccak_state *restrict state,
+                       register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block64(state->S.w64, message, rr);
+		KECCAK_F(state->S.w64, uint64_t, state->nr, &rc64[24 - state->nr], rotate64, ANDN);
+	}
+}
+# endif
+
+
+# if INTERLEAVED_PAIRS
+
+
+/**
+ * Version of `libkeccak_f64` that permutes two sponges at
+ * once, with their instructions interleaved
+ * 
+ * @param  state1  The first hashing state
+ * @param  state2  The second hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f64_pair(register struct libkeccak_state *restrict state1, register struct libkeccak_state *restrict state2)
+{
+	KECCAK_F2(state1->S.w64, state2->S.w64, uint64_t, state1->nr, &rc64[24 - state1->nr], rotate64, CHI_DEFAULT);
+}
+
+
+/**
+ * Version of `libkeccak_absorb64` that absorbs into
+ * two sponges at once, see `libkeccak_f64_pair`
+ * 
+ * @param  state1    The first hashing state
+ * @param  message1  The blocks to absorb into `state1`
+ * @param  state2    The second hashing state
+ * @param  message2  The blocks to absorb into `state2`
+ * @param  n         The number of blocks to absorb into each state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb64_pair(register struct libkeccak_state *restrict state1, register const unsigned char *restrict message1,
+                        register struct libkeccak_state *restrict state2, register const unsigned char *restrict message2,
+                        register size_t n)
+{
+	register long int rr = state1->r >> 3;
+	for (; n--; message1 += (size_t)rr, message2 += (size_t)rr) {
+		libkeccak_absorb_block64(state1->S.w64, message1, rr);
+		libkeccak_absorb_block64(state2->S.w64, message2, rr);
+		KECCAK_F2(state1->S.w64, state2->S.w64, uint64_t, state1->nr, &rc64[24 - state1->nr], rotate64, CHI_DEFAULT);
+	}
+}
+
+
+#  if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_f64_pair` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state1  The first hashing state
+ * @param  state2  The second hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_f64_pair_bmi(register struct libkeccak_state *restrict state1, register struct libkeccak_state *restrict state2)
+{
+	KECCAK_F2(state1->S.w64, state2->S.w64, uint64_t, state1->nr, &rc64[24 - state1->nr], rotate64, ANDN);
+}
+
+
+/**
+ * Version of `libkeccak_absorb64_pair` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state1    The first hashing state
+ * @param  message1  The blocks to absorb into `state1`
+ * @param  state2    The second hashing state
+ * @param  message2  The blocks to absorb into `state2`
+ * @param  n         The number of blocks to absorb into each state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_absorb64_pair_bmi(register struct libkeccak_state *restrict state1, register const unsigned char *restrict message1,
+                            register struct libkeccak_state *restrict state2, register const unsigned char *restrict message2,
+                            register size_t n)
+{
+	register long int rr = state1->r >> 3;
+	for (; n--; message1 += (size_t)rr, message2 += (size_t)rr) {
+		libkeccak_absorb_block64(state1->S.w64, message1, rr);
+		libkeccak_absorb_block64(state2->S.w64, message2, rr);
+		KECCAK_F2(state1->S.w64, state2->S.w64, uint64_t, state1->nr, &rc64[24 - state1->nr], rotate64, ANDN);
+	}
+}
+#  endif
+
+
+# endif
+
+
+#endif
+
+
+#if BIT_INTERLEAVED_1600
+
+
+/*
+ * On 32-bit CPUs, 64-bit rotations are expensive, so Keccak-f[1600]
+ * is instead performed on bit-interleaved lanes: each lane is split
+ * into two 32-bit words, one with the even bits and one with the odd
+ * bits, so that each 64-bit rotation becomes two 32-bit rotations.
+ * The sponge in `struct libkeccak_state` is not interleaved, it is
+ * interleaved on entry and deinterleaved on exit, and when absorbing,
+ * the sponge stays interleaved between the blocks.
+ * 
+ * Interleaved lane N is stored at index 2N (even bits) and 2N + 1
+ * (odd bits) in a `uint32_t[50]`.
+ */
+
+
+/**
+ * The even bits of the 64-bit Keccak-f round constants
+ */
+static const uint32_t rc64e[] = {
+	UINT32_C(0x00000001), UINT32_C(0x00000000), UINT32_C(0x00000000), UINT32_C(0x00000000), UINT32_C(0x00000001), UINT32_C(0x00000001),
+	UINT32_C(0x00000001), UINT32_C(0x00000001), UINT32_C(0x00000000), UINT32_C(0x00000000), UINT32_C(0x00000001), UINT32_C(0x00000000),
+	UINT32_C(0x00000001), UINT32_C(0x00000001), UINT32_C(0x00000001), UINT32_C(0x00000001), UINT32_C(0x00000000), UINT32_C(0x00000000),
+	UINT32_C(0x00000000), UINT32_C(0x00000000), UINT32_C(0x00000001), UINT32_C(0x00000000), UINT32_C(0x00000001), UINT32_C(0x00000000)
+};
+
+
+/**
+ * The odd bits of the 64-bit Keccak-f round constants
+ */
+static const uint32_t rc64o[] = {
+	UINT32_C(0x00000000), UINT32_C(0x00000089), UINT32_C(0x8000008B), UINT32_C(0x80008080), UINT32_C(0x0000008B), UINT32_C(0x00008000),
+	UINT32_C(0x80008088), UINT32_C(0x80000082), UINT32_C(0x0000000B), UINT32_C(0x0000000A), UINT32_C(0x00008082), UINT32_C(0x00008003),
+	UINT32_C(0x0000808B), UINT32_C(0x8000000B), UINT32_C(0x8000008A), UINT32_C(0x80000081), UINT32_C(0x80000081), UINT32_C(0x80000008),
+	UINT32_C(0x00000083), UINT32_C(0x80008003), UINT32_C(0x80008088), UINT32_C(0x80000088), UINT32_C(0x00008000), UINT32_C(0x80008082)
+};
+
+
+/**
+ * Rotate a 32-bit word
+ * 
+ * @param   x:uint32_t  The value to rotate
+ * @param   n:long int  Rotation steps, may be zero
+ * @return   :uint32_t  The value rotated
+ */
+# define rotate32_bi(x, n) ((uint32_t)(((uint32_t)(x) >> ((32L - (n)) & 31L)) | ((uint32_t)(x) << ((n) & 31L))))
+
+
+/**
+ * Rotate a bit-interleaved 64-bit lane, after adding
+ * θ's effect to it, and get the even bits
+ * 
+ * @param   IE, IO  The prefix of the variables with the even and odd bits of the lanes
+ * @param   N       The index of the lane
+ * @param   d       The name of the variables, less the suffix `e` or `o`, for θ's effect
+ * @param   r       The number of steps to rotate the 64-bit lane
+ * @return          The even bits of the rotated lane
+ */
+# define BI_RHO_E(IE, IO, N, d, r)\
+	((r) & 1 ? rotate32_bi(IO##N ^ d##o, ((r) + 1) / 2) : rotate32_bi(IE##N ^ d##e, (r) / 2))
+
+/**
+ * Rotate a bit-interleaved 64-bit lane, after adding
+ * θ's effect to it, and get the odd bits
+ * 
+ * @param   IE, IO  The prefix of the variables with the even and odd bits of the lanes
+ * @param   N       The index of the lane
+ * @param   d       The name of the variables, less the suffix `e` or `o`, for θ's effect
+ * @param   r       The number of steps to rotate the 64-bit lane
+ * @return          The odd bits of the rotated lane
+ */
+# define BI_RHO_O(IE, IO, N, d, r)\
+	((r) & 1 ? rotate32_bi(IE##N ^ d##e, ((r) - 1) / 2) : rotate32_bi(IO##N ^ d##o, (r) / 2))
+
+
+/**
+ * Bit-interleaved version of `KECCAK_ROUND` for Keccak-f[1600]
+ * 
+ * @param  CHI       The χ version, `ANDN` or `COMPLEMENTED`
+ * @param  IE, IO    The prefix of the input variables with the even and odd bits
+ * @param  OE, OO    The prefix of the output variables with the even and odd bits
+ * @param  rce, rco  The even and odd bits of the round constant
+ */
+# define KECCAK_ROUND_BI(CHI, IE, IO, OE, OO, rce, rco)\
+	do {\
+		c0e = IE##0 ^ IE##5 ^ IE##10 ^ IE##15 ^ IE##20;\
+		c1e = IE##1 ^ IE##6 ^ IE##11 ^ IE##16 ^ IE##21;\
+		c2e = IE##2 ^ IE##7 ^ IE##12 ^ IE##17 ^ IE##22;\
+		c3e = IE##3 ^ IE##8 ^ IE##13 ^ IE##18 ^ IE##23;\
+		c4e = IE##4 ^ IE##9 ^ IE##14 ^ IE##19 ^ IE##24;\
+		c0o = IO##0 ^ IO##5 ^ IO##10 ^ IO##15 ^ IO##20;\
+		c1o = IO##1 ^ IO##6 ^ IO##11 ^ IO##16 ^ IO##21;\
+		c2o = IO##2 ^ IO##7 ^ IO##12 ^ IO##17 ^ IO##22;\
+		c3o = IO##3 ^ IO##8 ^ IO##13 ^ IO##18 ^ IO##23;\
+		c4o = IO##4 ^ IO##9 ^ IO##14 ^ IO##19 ^ IO##24;\
+		dae = c4e ^ rotate32_bi(c1o, 1); dao = c4o ^ c1e;\
+		dbe = c0e ^ rotate32_bi(c2o, 1); dbo = c0o ^ c2e;\
+		dce = c1e ^ rotate32_bi(c3o, 1); dco = c1o ^ c3e;\
+		dde = c2e ^ rotate32_bi(c4o, 1); ddo = c2o ^ c4e;\
+		dee = c3e ^ rotate32_bi(c0o, 1); deo = c3o ^ c0e;\
+		b0 = BI_RHO_E(IE, IO, 0, da, 0);\
+		b1 = BI_RHO_E(IE, IO, 6, db, 44);\
+		b2 = BI_RHO_E(IE, IO, 12, dc, 43);\
+		b3 = BI_RHO_E(IE, IO, 18, dd, 21);\
+		b4 = BI_RHO_E(IE, IO, 24, de, 14);\
+		CHI_##CHI##_PLANE0(uint32_t, , OE##0, OE##1, OE##2, OE##3, OE##4);\
+		b0 = BI_RHO_O(IE, IO, 0, da, 0);\
+		b1 = BI_RHO_O(IE, IO, 6, db, 44);\
+		b2 = BI_RHO_O(IE, IO, 12, dc, 43);\
+		b3 = BI_RHO_O(IE, IO, 18, dd, 21);\
+		b4 = BI_RHO_O(IE, IO, 24, de, 14);\
+		CHI_##CHI##_PLANE0(uint32_t, , OO##0, OO##1, OO##2, OO##3, OO##4);\
+		b0 = BI_RHO_E(IE, IO, 3, dd, 28);\
+		b1 = BI_RHO_E(IE, IO, 9, de, 20);\
+		b2 = BI_RHO_E(IE, IO, 10, da, 3);\
+		b3 = BI_RHO_E(IE, IO, 16, db, 45);\
+		b4 = BI_RHO_E(IE, IO, 22, dc, 61);\
+		CHI_##CHI##_PLANE1(uint32_t, , OE##5, OE##6, OE##7, OE##8, OE##9);\
+		b0 = BI_RHO_O(IE, IO, 3, dd, 28);\
+		b1 = BI_RHO_O(IE, IO, 9, de, 20);\
+		b2 = BI_RHO_O(IE, IO, 10, da, 3);\
+		b3 = BI_RHO_O(IE, IO, 16, db, 45);\
+		b4 = BI_RHO_O(IE, IO, 22, dc, 61);\
+		CHI_##CHI##_PLANE1(uint32_t, , OO##5, OO##6, OO##7, OO##8, OO##9);\
+		b0 = BI_RHO_E(IE, IO, 1, db, 1);\
+		b1 = BI_RHO_E(IE, IO, 7, dc, 6);\
+		b2 = BI_RHO_E(IE, IO, 13, dd, 25);\
+		b3 = BI_RHO_E(IE, IO, 19, de, 8);\
+		b4 = BI_RHO_E(IE, IO, 20, da, 18);\
+		CHI_##CHI##_PLANE2(uint32_t, , OE##10, OE##11, OE##12, OE##13, OE##14);\
+		b0 = BI_RHO_O(IE, IO, 1, db, 1);\
+		b1 = BI_RHO_O(IE, IO, 7, dc, 6);\
+		b2 = BI_RHO_O(IE, IO, 13, dd, 25);\
+		b3 = BI_RHO_O(IE, IO, 19, de, 8);\
+		b4 = BI_RHO_O(IE, IO, 20, da, 18);\
+		CHI_##CHI##_PLANE2(uint32_t, , OO##10, OO##11, OO##12, OO##13, OO##14);\
+		b0 = BI_RHO_E(IE, IO, 4, de, 27);\
+		b1 = BI_RHO_E(IE, IO, 5, da, 36);\
+		b2 = BI_RHO_E(IE, IO, 11, db, 10);\
+		b3 = BI_RHO_E(IE, IO, 17, dc, 15);\
+		b4 = BI_RHO_E(IE, IO, 23, dd, 56);\
+		CHI_##CHI##_PLANE3(uint32_t, , OE##15, OE##16, OE##17, OE##18, OE##19);\
+		b0 = BI_RHO_O(IE, IO, 4, de, 27);\
+		b1 = BI_RHO_O(IE, IO, 5, da, 36);\
+		b2 = BI_RHO_O(IE, IO, 11, db, 10);\
+		b3 = BI_RHO_O(IE, IO, 17, dc, 15);\
+		b4 = BI_RHO_O(IE, IO, 23, dd, 56);\
+		CHI_##CHI##_PLANE3(uint32_t, , OO##15, OO##16, OO##17, OO##18, OO##19);\
+		b0 = BI_RHO_E(IE, IO, 2, dc, 62);\
+		b1 = BI_RHO_E(IE, IO, 8, dd, 55);\
+		b2 = BI_RHO_E(IE, IO, 14, de, 39);\
+		b3 = BI_RHO_E(IE, IO, 15, da, 41);\
+		b4 = BI_RHO_E(IE, IO, 21, db, 2);\
+		CHI_##CHI##_PLANE4(uint32_t, , OE##20, OE##21, OE##22, OE##23, OE##24);\
+		b0 = BI_RHO_O(IE, IO, 2, dc, 62);\
+		b1 = BI_RHO_O(IE, IO, 8, dd, 55);\
+		b2 = BI_RHO_O(IE, IO, 14, de, 39);\
+		b3 = BI_RHO_O(IE, IO, 15, da, 41);\
+		b4 = BI_RHO_O(IE, IO, 21, db, 2);\
+		CHI_##CHI##_PLANE4(uint32_t, , OO##20, OO##21, OO##22, OO##23, OO##24);\
+		OE##0 ^= (rce);\
+		OO##0 ^= (rco);\
+	} while (0)
+
+
+/**
+ * Bit-interleaved version of `KECCAK_F` for Keccak-f[1600]
+ * 
+ * @param  A    The interleaved lanes, `uint32_t *`
+ * @param  NR   The number of rounds, the last `NR` rounds are performed
+ * @param  CHI  The χ version, `ANDN`, `COMPLEMENTED`, or `CHI_DEFAULT`
+ */
+# define KECCAK_F_BI(A, NR, CHI) KECCAK_F_BI_(A, NR, CHI)
+# define KECCAK_F_BI_(A, NR, CHI)\
+	do {\
+		uint32_t *restrict lanes__ = (A);\
+		uint32_t ae0 = lanes__[0], ae1 = lanes__[2], ae2 = lanes__[4], ae3 = lanes__[6], ae4 = lanes__[8];\
+		uint32_t ae5 = lanes__[10], ae6 = lanes__[12], ae7 = lanes__[14], ae8 = lanes__[16], ae9 = lanes__[18];\
+		uint32_t ae10 = lanes__[20], ae11 = lanes__[22], ae12 = lanes__[24], ae13 = lanes__[26], ae14 = lanes__[28];\
+		uint32_t ae15 = lanes__[30], ae16 = lanes__[32], ae17 = lanes__[34], ae18 = lanes__[36], ae19 = lanes__[38];\
+		uint32_t ae20 = lanes__[40], ae21 = lanes__[42], ae22 = lanes__[44], ae23 = lanes__[46], ae24 = lanes__[48];\
+		uint32_t ao0 = lanes__[1], ao1 = lanes__[3], ao2 = lanes__[5], ao3 = lanes__[7], ao4 = lanes__[9];\
+		uint32_t ao5 = lanes__[11], ao6 = lanes__[13], ao7 = lanes__[15], ao8 = lanes__[17], ao9 = lanes__[19];\
+		uint32_t ao10 = lanes__[21], ao11 = lanes__[23], ao12 = lanes__[25], ao13 = lanes__[27], ao14 = lanes__[29];\
+		uint32_t ao15 = lanes__[31], ao16 = lanes__[33], ao17 = lanes__[35], ao18 = lanes__[37], ao19 = lanes__[39];\
+		uint32_t ao20 = lanes__[41], ao21 = lanes__[43], ao22 = lanes__[45], ao23 = lanes__[47], ao24 = lanes__[49];\
+		uint32_t ee0, ee1, ee2, ee3, ee4, ee5, ee6, ee7, ee8, ee9, ee10, ee11, ee12;\
+		uint32_t ee13, ee14, ee15, ee16, ee17, ee18, ee19, ee20, ee21, ee22, ee23, ee24;\
+		uint32_t eo0, eo1, eo2, eo3, eo4, eo5, eo6, eo7, eo8, eo9, eo10, eo11, eo12;\
+		uint32_t eo13, eo14, eo15, eo16, eo17, eo18, eo19, eo20, eo21, eo22, eo23, eo24;\
+		uint32_t b0, b1, b2, b3, b4, c0e, c1e, c2e, c3e, c4e, c0o, c1o, c2o, c3o, c4o;\
+		uint32_t dae, dbe, dce, dde, dee, dao, dbo, dco, ddo, deo;\
+		long int i__ = 24 - (NR);\
+		COMPLEMENT_LANES_##CHI(uint32_t, ae);\
+		COMPLEMENT_LANES_##CHI(uint32_t, ao);\
+		if ((NR) & 1) {\
+			KECCAK_ROUND_BI(CHI, ae, ao, ee, eo, rc64e[i__], rc64o[i__]);\
+			COPY_LANES(ae, ee);\
+			COPY_LANES(ao, eo);\
+			i__ += 1;\
+		}\
+		for (; i__ < 24; i__ += 2) {\
+			KECCAK_ROUND_BI(CHI, ae, ao, ee, eo, rc64e[i__], rc64o[i__]);\
+			KECCAK_ROUND_BI(CHI, ee, eo, ae, ao, rc64e[i__ + 1], rc64o[i__ + 1]);\
+		}\
+		COMPLEMENT_LANES_##CHI(uint32_t, ae);\
+		COMPLEMENT_LANES_##CHI(uint32_t, ao);\
+		lanes__[0] = ae0; lanes__[1] = ao0; lanes__[2] = ae1; lanes__[3] = ao1; lanes__[4] = ae2; lanes__[5] = ao2; lanes__[6] = ae3; lanes__[7] = ao3;\
+		lanes__[8] = ae4; lanes__[9] = ao4; lanes__[10] = ae5; lanes__[11] = ao5; lanes__[12] = ae6; lanes__[13] = ao6; lanes__[14] = ae7; lanes__[15] = ao7;\
+		lanes__[16] = ae8; lanes__[17] = ao8; lanes__[18] = ae9; lanes__[19] = ao9; lanes__[20] = ae10; lanes__[21] = ao10; lanes__[22] = ae11; lanes__[23] = ao11;\
+		lanes__[24] = ae12; lanes__[25] = ao12; lanes__[26] = ae13; lanes__[27] = ao13; lanes__[28] = ae14; lanes__[29] = ao14; lanes__[30] = ae15; lanes__[31] = ao15;\
+		lanes__[32] = ae16; lanes__[33] = ao16; lanes__[34] = ae17; lanes__[35] = ao17; lanes__[36] = ae18; lanes__[37] = ao18; lanes__[38] = ae19; lanes__[39] = ao19;\
+		lanes__[40] = ae20; lanes__[41] = ao20; lanes__[42] = ae21; lanes__[43] = ao21; lanes__[44] = ae22; lanes__[45] = ao22; lanes__[46] = ae23; lanes__[47] = ao23;\
+		lanes__[48] = ae24; lanes__[49] = ao24;\
+	} while (0)
+
+
+/**
+ * Separate the even and odd bits of a 32-bit word
+ * 
+ * @param   x  The word
+ * @return     The even bits of `x` in the lower half,
+ *             and the odd bits of `x` in the upper half
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__const__, __nothrow__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint32_t
+libkeccak_unshuffle32(register uint32_t x)
+{
+	register uint32_t t;
+	t = (x ^ (x >> 1)) & UINT32_C(0x22222222);
+	x ^= t ^ (t << 1);
+	t = (x ^ (x >> 2)) & UINT32_C(0x0C0C0C0C);
+	x ^= t ^ (t << 2);
+	t = (x ^ (x >> 4)) & UINT32_C(0x00F000F0);
+	x ^= t ^ (t << 4);
+	t = (x ^ (x >> 8)) & UINT32_C(0x0000FF00);
+	x ^= t ^ (t << 8);
+	return x;
+}
+
+
+/**
+ * Inverse of `libkeccak_unshuffle32`
+ * 
+ * @param   x  The even bits in the lower half, and the odd bits in the upper half
+ * @return     The word
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__const__, __nothrow__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint32_t
+libkeccak_shuffle32(register uint32_t x)
+{
+	register uint32_t t;
+	t = (x ^ (x >> 8)) & UINT32_C(0x0000FF00);
+	x ^= t ^ (t << 8);
+	t = (x ^ (x >> 4)) & UINT32_C(0x00F000F0);
+	x ^= t ^ (t << 4);
+	t = (x ^ (x >> 2)) & UINT32_C(0x0C0C0C0C);
+	x ^= t ^ (t << 2);
+	t = (x ^ (x >> 1)) & UINT32_C(0x22222222);
+	x ^= t ^ (t << 1);
+	return x;
+}
+
+
+/**
+ * Bit-interleave a 64-bit lane and add it to an interleaved lane
+ * 
+ * @param  A     The interleaved lane, two words
+ * @param  lane  The lane to add
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_interleave_xor(register uint32_t *restrict A, register uint64_t lane)
+{
+	register uint32_t lo = libkeccak_unshuffle32((uint32_t)lane);
+	register uint32_t hi = libkeccak_unshuffle32((uint32_t)(lane >> 32));
+	A[0] ^= (lo & UINT32_C(0x0000FFFF)) | (hi << 16);
+	A[1] ^= (lo >> 16) | (hi & UINT32_C(0xFFFF0000));
+}
+
+
+/**
+ * Deinterleave a bit-interleaved 64-bit lane
+ * 
+ * @param   A  The interleaved lane, two words
+ * @return     The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint64_t
+libkeccak_deinterleave(register const uint32_t *restrict A)
+{
+	register uint32_t lo = libkeccak_shuffle32((A[0] & UINT32_C(0x0000FFFF)) | (A[1] << 16));
+	register uint32_t hi = libkeccak_shuffle32((A[0] >> 16) | (A[1] & UINT32_C(0xFFFF0000)));
+	return (uint64_t)lo | ((uint64_t)hi << 32);
+}
+
+
+/**
+ * Bit-interleave the sponge
+ * 
+ * @param  A  Output parameter for the interleaved lanes
+ * @param  S  The lanes of the sponge
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_interleave_sponge(register uint32_t *restrict A, register const uint64_t *restrict S)
+{
+	register long int i;
+	for (i = 0; i < 25; i++) {
+		A[2 * i] = A[2 * i + 1] = 0;
+		libkeccak_interleave_xor(&A[2 * i], S[i]);
+	}
+}
+
+
+/**
+ * Inverse of `libkeccak_interleave_sponge`
+ * 
+ * @param  S  Output parameter for the lanes of the sponge
+ * @param  A  The interleaved lanes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_deinterleave_sponge(register uint64_t *restrict S, register const uint32_t *restrict A)
+{
+	register long int i;
+	for (i = 0; i < 25; i++)
+		S[i] = libkeccak_deinterleave(&A[2 * i]);
+}
+
+
+/**
+ * Bit-interleaved version of `libkeccak_absorb_block64`
+ * 
+ * @param  A        The interleaved lanes of the sponge
+ * @param  message  The block to absorb, must be at least `rr` bytes
+ * @param  rr       Bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_absorb_block64_bi(register uint32_t *restrict A, register const unsigned char *restrict message, register long int rr)
+{
+	register long int i, n = rr >> 3;
+	for (i = 0; i < n; i++)
+		libkeccak_interleave_xor(&A[2 * i], libkeccak_load64(&message[i * 8]));
+	if (rr & 7)
+		libkeccak_interleave_xor(&A[2 * n], libkeccak_to_lane64(message, (size_t)rr, rr, (size_t)(n * 8)));
+}
+
+
+
+/**
+ * 64-bit word version of `libkeccak_f`, using
+ * bit-interleaved lanes internally
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f64(register struct libkeccak_state *state)
+{
+	uint32_t A[50];
+	libkeccak_interleave_sponge(A, state->S.w64);
+	KECCAK_F_BI(A, state->nr, CHI_DEFAULT);
+	libkeccak_deinterleave_sponge(state->S.w64, A);
+}
+
+
+/**
+ * Absorb whole blocks into a sponge with 64-bit lanes,
+ * and permute the sponge after each block, using
+ * bit-interleaved lanes internally
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb64(register struct libkeccak_state *restrict state,
+                   register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	uint32_t A[50];
+	libkeccak_interleave_sponge(A, state->S.w64);
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block64_bi(A, message, rr);
+		KECCAK_F_BI(A, state->nr, CHI_DEFAULT);
+	}
+	libkeccak_deinterleave_sponge(state->S.w64, A);
+}
+
+
+# if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_f64` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_f64_bmi(register struct libkeccak_state *state)
+{
+	uint32_t A[50];
+	libkeccak_interleave_sponge(A, state->S.w64);
+	KECCAK_F_BI(A, state->nr, ANDN);
+	libkeccak_deinterleave_sponge(state->S.w64, A);
+}
+
+
+/**
+ * Version of `libkeccak_absorb64` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_absorb64_bmi(register struct libkeccak_state *restrict state,
+                       register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	uint32_t A[50];
+	libkeccak_interleave_sponge(A, state->S.w64);
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block64_bi(A, message, rr);
+		KECCAK_F_BI(A, state->nr, ANDN);
+	}
+	libkeccak_deinterleave_sponge(state->S.w64, A);
+}
+# endif
+
+
+#endif
+
+
+/**
+ * Output at most one block from a sponge with 64-bit lanes
+ * 
+ * @param  state    The hashing state
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_squeeze64(register const struct libkeccak_state *restrict state,
+                    register unsigned char *restrict hashsum, register long int len)
+{
+	libkeccak_squeeze_block64(state->S.w64, hashsum, len);
+}
@@ -0,0 +1,176 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/*
+ * The sponges processed by the functions in this file are stored
+ * interleaved, such that lane N of sponge K is stored at index
+ * `N * 4 + K`, this way one lane from all four sponges can be
+ * loaded into one 256-bit register.
+ */
+
+
+#if defined(__AVX2__) || defined(HAVE_X86_DISPATCH)
+# include <immintrin.h>
+
+
+/**
+ * Rotate four 64-bit words
+ *
+ * @param   x:__m256i   The values to rotate
+ * @param   n:long int  Rotation steps, may not be zero
+ * @return   :__m256i   The values rotated
+ */
+# define rotate64x4(x, n) _mm256_or_si256(_mm256_slli_epi64((x), (n)), _mm256_srli_epi64((x), 64 - (n)))
+
+
+/**
+ * Perform one round of Keccak-f on interleaved sponges, this
+ * is shared by all multi-buffer kernels, which only differ
+ * in the size of the words in the 256-bit registers
+ *
+ * @param  A       :__m256i *  One lane from each sponge per element
+ * @param  ROTATE  Macro that takes a vector and a rotation offset
+ *                 for 64-bit lanes, and rotates each word in the
+ *                 vector, the offset may be a multiple of the
+ *                 word size only if `ROTATE` supports that
+ * @param  rc      :__m256i    The round constant in every word
+ */
+# define KECCAK_ROUND_AVX2(A, ROTATE, rc)\
+	do {\
+		__m256i *restrict A__ = (A);\
+		__m256i B__[25], C__[5], da__, db__, dc__, dd__, de__;\
+		\
+		/* θ step (step 1 of 3). */\
+		KECCAK_ROUND_AVX2_COLUMN_(0);\
+		KECCAK_ROUND_AVX2_COLUMN_(1);\
+		KECCAK_ROUND_AVX2_COLUMN_(2);\
+		KECCAK_ROUND_AVX2_COLUMN_(3);\
+		KECCAK_ROUND_AVX2_COLUMN_(4);\
+		\
+		/* θ step (step 2 of 3). */\
+		da__ = _mm256_xor_si256(C__[4], ROTATE(C__[1], 1));\
+		dd__ = _mm256_xor_si256(C__[2], ROTATE(C__[4], 1));\
+		db__ = _mm256_xor_si256(C__[0], ROTATE(C__[2], 1));\
+		de__ = _mm256_xor_si256(C__[3], ROTATE(C__[0], 1));\
+		dc__ = _mm256_xor_si256(C__[1], ROTATE(C__[3], 1));\
+		\
+		/* ρ and π steps, with last two part of θ. */\
+		B__[0] = _mm256_xor_si256(A__[0], da__);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  1,  6, db__, 44);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  2, 12, dc__, 43);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  3, 18, dd__, 21);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  4, 24, de__, 14);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  5,  3, dd__, 28);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  6,  9, de__, 20);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  7, 10, da__,  3);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  8, 16, db__, 45);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE,  9, 22, dc__, 61);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 10,  1, db__,  1);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 11,  7, dc__,  6);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 12, 13, dd__, 25);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 13, 19, de__,  8);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 14, 20, da__, 18);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 15,  4, de__, 27);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 16,  5, da__, 36);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 17, 11, db__, 10);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 18, 17, dc__, 15);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 19, 23, dd__, 56);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 20,  2, dc__, 62);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 21,  8, dd__, 55);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 22, 14, de__, 39);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 23, 15, da__, 41);\
+		KECCAK_ROUND_AVX2_RHO_(ROTATE, 24, 21, db__,  2);\
+		\
+		/* ξ step. */\
+		LIST_25(KECCAK_ROUND_AVX2_CHI_, ;);\
+		\
+		/* ι step. */\
+		A__[0] = _mm256_xor_si256(A__[0], (rc));\
+	} while (0)
+# define KECCAK_ROUND_AVX2_COLUMN_(N)\
+	C__[N] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(A[N], A[N + 5]),\
+	                                           _mm256_xor_si256(A[N + 10], A[N + 15])),\
+	                          A[N + 20])
+# define KECCAK_ROUND_AVX2_RHO_(ROTATE, bi, ai, dv, r)\
+	B__[bi] = ROTATE(_mm256_xor_si256(A[ai], dv), r)
+# define KECCAK_ROUND_AVX2_CHI_(N)\
+	A[N] = _mm256_xor_si256(B__[N], _mm256_andnot_si256(B__[N - N % 5 + (N + 1) % 5], B__[N - N % 5 + (N + 2) % 5]))
+
+
+/**
+ * 4-way 64-bit word version of `libkeccak_f`, for CPUs with AVX2
+ *
+ * @param  S   The interleaved lanes of the four sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("avx2"))))
+static void
+libkeccak_f64x4_avx2(register uint64_t *restrict S, register long int nr)
+{
+	__m256i A[25];
+	long int i;
+
+# define X(N) A[N] = _mm256_loadu_si256((const void *)&S[N * 4])
+	LIST_25(X, ;);
+# undef X
+
+	for (i = 24 - nr; i < 24; i++)
+		KECCAK_ROUND_AVX2(A, rotate64x4, _mm256_set1_epi64x((long long int)rc64[i]));
+
+# define X(N) _mm256_storeu_si256((void *)&S[N * 4], A[N])
+	LIST_25(X, ;);
+# undef X
+}
+
+
+#endif
+
+
+#if defined(__AVX2__)
+
+
+/**
+ * 4-way 64-bit word version of `libkeccak_f`
+ *
+ * @param  S   The interleaved lanes of the four sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+# define libkeccak_f64x4 libkeccak_f64x4_avx2
+
+
+#else
+
+
+/**
+ * 4-way 64-bit word version of `libkeccak_f`
+ *
+ * This is the fallback used when AVX2 is not available,
+ * and simply permutes the four sponges one at a time
+ *
+ * @param  S   The interleaved lanes of the four sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f64x4(register uint64_t *restrict S, register long int nr)
+{
+	struct libkeccak_state state;
+	long int k;
+
+	state.nr = nr;
+	for (k = 0; k < 4; k++) {
+# define X(N) state.S.w64[N] = S[N * 4 + k]
+		LIST_25(X, ;);
+# undef X
+		libkeccak_f64(&state);
+# define X(N) S[N * 4 + k] = state.S.w64[N]
+		LIST_25(X, ;);
+# undef X
+	}
+}
+
+
+#endif
@@ -23,6 +23,17 @@ static const uint_fast8_t rc8[] = {
 #define rotate8(x, n) ((uint_fast8_t)(((uint_fast8_t)(x) >> (8L - (n))) | ((uint_fast8_t)(x) << (n))))
 
 
+/**
+ * Defined if the SSSE3 kernels for 8-bit words are selected
+ * at compile time, the scalar kernels are then only needed
+ * for the fallback of the 32-way kernel
+ */
+#if defined(__SSSE3__) && UINT_FAST8_MAX == UINT8_MAX
+# define SSSE3_KERNELS8 1
+#endif
+
+
+#if !defined(SSSE3_KERNELS8) || !defined(__AVX2__)
 /**
  * 8-bit word version of `libkeccak_f`
  * 
@@ -35,11 +46,11 @@ libkeccak_f8(register struct libkeccak_state *state)
 #define A state->S.w8
 
 	uint_fast8_t B[25], C[5], da, db, dc, dd, de;
-	int i;
+	long int i;
 
-	for (i = 0; i < 18; i++) {
+	for (i = 18 - state->nr; i < 18; i++) {
 		/* θ step (step 1 of 3). */
-#define X(N) C[N] = A[N * 5] ^ A[N * 5 + 1] ^ A[N * 5 + 2] ^ A[N * 5 + 3] ^ A[N * 5 + 4]
+#define X(N) C[N] = A[N] ^ A[N + 5] ^ A[N + 10] ^ A[N + 15] ^ A[N + 20]
 		LIST_5(X, ;);
 #undef X
 
@@ -52,15 +63,15 @@ libkeccak_f8(register struct libkeccak_state *state)
 
 		/* ρ and π steps, with last two part of θ. */
 #define X(bi, ai, dv, r) B[bi] = rotate8(A[ai] ^ dv, r)
-		B[0] = A[0] ^ da;  X( 1, 15, dd, 4);  X( 2,  5, db, 1);  X( 3, 20, de, 3);  X( 4, 10, dc, 6);
-		X( 5,  6, db, 4);  X( 6, 21, de, 4);  X( 7, 11, dc, 6);  X( 8,  1, da, 4);  X( 9, 16, dd, 7);
-		X(10, 12, dc, 3);  X(11,  2, da, 3);  X(12, 17, dd, 1);  X(13,  7, db, 2);  X(14, 22, de, 7);
-		X(15, 18, dd, 5);  X(16,  8, db, 5);  B[17] = A[23]^de;  X(18, 13, dc, 7);  X(19,  3, da, 1);
-		X(20, 24, de, 6);  X(21, 14, dc, 5);  X(22,  4, da, 2);  B[23] = A[19]^dd;  X(24,  9, db, 2);
+		B[0] = A[0] ^ da;  X( 1,  6, db, 4);  X( 2, 12, dc, 3);  X( 3, 18, dd, 5);  X( 4, 24, de, 6);
+		X( 5,  3, dd, 4);  X( 6,  9, de, 4);  X( 7, 10, da, 3);  X( 8, 16, db, 5);  X( 9, 22, dc, 5);
+		X(10,  1, db, 1);  X(11,  7, dc, 6);  X(12, 13, dd, 1);  B[13] = A[19]^de;  X(14, 20, da, 2);
+		X(15,  4, de, 3);  X(16,  5, da, 4);  X(17, 11, db, 2);  X(18, 17, dc, 7);  B[19] = A[23]^dd;
+		X(20,  2, dc, 6);  X(21,  8, dd, 7);  X(22, 14, de, 7);  X(23, 15, da, 1);  X(24, 21, db, 2);
 #undef X
 
 		/* ξ step. */
-#define X(N) A[N] = (uint8_t)(B[N] ^ ((~(B[(N + 5) % 25])) & B[(N + 10) % 25]))
+#define X(N) A[N] = (uint8_t)(B[N] ^ ((~(B[N - N % 5 + (N + 1) % 5])) & B[N - N % 5 + (N + 2) % 5]))
 		LIST_25(X, ;);
 #undef X
 
@@ -70,6 +81,7 @@ libkeccak_f8(register struct libkeccak_state *state)
 
 #undef A
 }
+#endif
 
 
 /**
@@ -90,3 +102,183 @@ libkeccak_to_lane8(register const unsigned char *message, register size_t msglen
 		return (uint8_t)message[off];
 	return 0;
 }
+
+
+/**
+ * Read an 8-bit lane
+ * 
+ * @param   message  The lane's location in the message
+ * @return           The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint8_t
+libkeccak_load8(register const unsigned char *message)
+{
+	return (uint8_t)*message;
+}
+
+
+/**
+ * 8-bit lane version of `libkeccak_absorb_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  message  The block to absorb, must be at least `rr` bytes
+ * @param  rr       Bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_absorb_block8(register uint_fast8_t *restrict S, register const unsigned char *restrict message, register long int rr)
+{
+	register long int i;
+	for (i = 0; i < rr; i++)
+		S[i] ^= message[i];
+}
+
+
+/**
+ * 8-bit lane version of `libkeccak_squeeze_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_squeeze_block8(register const uint_fast8_t *restrict S, register unsigned char *restrict hashsum, register long int len)
+{
+	register long int i;
+	for (i = 0; i < len; i++)
+		hashsum[i] = (unsigned char)S[i];
+}
+
+
+#if !defined(SSSE3_KERNELS8)
+/**
+ * Absorb whole blocks into a sponge with 8-bit lanes,
+ * and permute the sponge after each block
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb8(register struct libkeccak_state *restrict state,
+                  register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block8(state->S.w8, message, rr);
+		libkeccak_f8(state);
+	}
+}
+#endif
+
+
+#if (defined(__SSSE3__) || defined(HAVE_X86_DISPATCH)) && UINT_FAST8_MAX == UINT8_MAX
+
+
+/**
+ * Load the rows of a sponge with 8-bit lanes
+ * 
+ * @param  R  Output parameter for the rows, see `libkeccak_f_rows16_ssse3`
+ * @param  S  The lanes of the sponge, must be followed by at least 3 bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline void
+libkeccak_load_rows8_ssse3(register __m128i *restrict R, register const uint_fast8_t *restrict S)
+{
+# define X(N) R[N] = _mm_unpacklo_epi8(_mm_loadl_epi64((const void *)&S[N * 5]), _mm_setzero_si128())
+	LIST_5(X, ;);
+# undef X
+}
+
+
+/**
+ * Store the rows of a sponge with 8-bit lanes
+ * 
+ * @param  S  Output parameter for the lanes of the sponge
+ * @param  R  The rows, see `libkeccak_f_rows16_ssse3`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline void
+libkeccak_store_rows8_ssse3(register uint_fast8_t *restrict S, register const __m128i *restrict R)
+{
+	int last;
+	/* Each store overwrites the beginning of the next row, which is then stored. */
+	_mm_storel_epi64((void *)&S[0 * 5], _mm_packus_epi16(R[0], R[0]));
+	_mm_storel_epi64((void *)&S[1 * 5], _mm_packus_epi16(R[1], R[1]));
+	_mm_storel_epi64((void *)&S[2 * 5], _mm_packus_epi16(R[2], R[2]));
+	_mm_storel_epi64((void *)&S[3 * 5], _mm_packus_epi16(R[3], R[3]));
+	last = _mm_cvtsi128_si32(_mm_packus_epi16(R[4], R[4]));
+	__builtin_memcpy(&S[4 * 5], &last, sizeof(last));
+	S[24] = (uint_fast8_t)_mm_extract_epi16(R[4], 4);
+}
+
+
+/**
+ * Version of `libkeccak_f8` for CPUs with SSSE3
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("ssse3"))))
+static void
+libkeccak_f8_ssse3(register struct libkeccak_state *state)
+{
+	__m128i R[5];
+	libkeccak_load_rows8_ssse3(R, state->S.w8);
+	libkeccak_f_rows16_ssse3(R, state->nr, 8);
+	libkeccak_store_rows8_ssse3(state->S.w8, R);
+}
+
+
+/**
+ * Version of `libkeccak_absorb8` for CPUs with SSSE3,
+ * the sponge is kept in registers between the blocks
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("ssse3"))))
+static void
+libkeccak_absorb8_ssse3(register struct libkeccak_state *restrict state,
+                        register const unsigned char *restrict message, register size_t n)
+{
+	register size_t rr = (size_t)(state->r >> 3);
+	const unsigned char *end = &message[n * rr];
+	__m128i R[5];
+
+	libkeccak_load_rows8_ssse3(R, state->S.w8);
+	for (; n--; message += rr) {
+# define X(N)\
+		if (rr > N * 5)\
+			R[N] = _mm_xor_si128(R[N], _mm_unpacklo_epi8(libkeccak_load_partial_ssse3(&message[N * 5],\
+			                                                                          rr - N * 5 < 5 ? rr - N * 5 : 5,\
+			                                                                          (size_t)(end - &message[N * 5])),\
+			                                             _mm_setzero_si128()))
+		LIST_5(X, ;);
+# undef X
+		libkeccak_f_rows16_ssse3(R, state->nr, 8);
+	}
+	libkeccak_store_rows8_ssse3(state->S.w8, R);
+}
+
+
+#endif
+
+
+/**
+ * Output at most one block from a sponge with 8-bit lanes
+ * 
+ * @param  state    The hashing state
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_squeeze8(register const struct libkeccak_state *restrict state,
+                   register unsigned char *restrict hashsum, register long int len)
+{
+	libkeccak_squeeze_block8(state->S.w8, hashsum, len);
+}
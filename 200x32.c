@@ -0,0 +1,104 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/*
+ * The sponges processed by the functions in this file are stored
+ * interleaved, such that lane N of sponge K is stored at index
+ * `N * 32 + K`, this way one lane from all thirty-two sponges can be
+ * loaded into one 256-bit register.
+ */
+
+
+#if defined(__AVX2__) || defined(HAVE_X86_DISPATCH)
+# include <immintrin.h>
+
+
+/**
+ * Rotate thirty-two 8-bit words
+ *
+ * @param   x:__m256i   The values to rotate
+ * @param   n:long int  Rotation steps for a 64-bit word
+ * @return   :__m256i   The values rotated
+ */
+# define rotate8x32(x, n)\
+	_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16((x), (n) % 8), _mm256_set1_epi8((char)(0xFF << (n) % 8))),\
+	                _mm256_and_si256(_mm256_srli_epi16((x), 8 - (n) % 8), _mm256_set1_epi8((char)(0xFF >> (8 - (n) % 8)))))
+
+
+/**
+ * 32-way 8-bit word version of `libkeccak_f`, for CPUs with AVX2
+ *
+ * @param  S   The interleaved lanes of the thirty-two sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("avx2"))))
+static void
+libkeccak_f8x32_avx2(register uint8_t *restrict S, register long int nr)
+{
+	__m256i A[25];
+	long int i;
+
+# define X(N) A[N] = _mm256_loadu_si256((const void *)&S[N * 32])
+	LIST_25(X, ;);
+# undef X
+
+	for (i = 18 - nr; i < 18; i++)
+		KECCAK_ROUND_AVX2(A, rotate8x32, _mm256_set1_epi8((char)rc8[i]));
+
+# define X(N) _mm256_storeu_si256((void *)&S[N * 32], A[N])
+	LIST_25(X, ;);
+# undef X
+}
+
+
+#endif
+
+
+#if defined(__AVX2__)
+
+
+/**
+ * 32-way 8-bit word version of `libkeccak_f`
+ *
+ * @param  S   The interleaved lanes of the thirty-two sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+# define libkeccak_f8x32 libkeccak_f8x32_avx2
+
+
+#else
+
+
+/**
+ * 32-way 8-bit word version of `libkeccak_f`
+ *
+ * This is the fallback used when AVX2 is not available,
+ * and simply permutes the thirty-two sponges one at a time
+ *
+ * @param  S   The interleaved lanes of the thirty-two sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f8x32(register uint8_t *restrict S, register long int nr)
+{
+	struct libkeccak_state state;
+	long int k;
+
+	state.nr = nr;
+	for (k = 0; k < 32; k++) {
+# define X(N) state.S.w8[N] = S[N * 32 + k]
+		LIST_25(X, ;);
+# undef X
+		libkeccak_f8(&state);
+# define X(N) S[N * 32 + k] = (uint8_t)state.S.w8[N]
+		LIST_25(X, ;);
+# undef X
+	}
+}
+
+
+#endif
@@ -24,47 +24,54 @@ static const uint16_t rc16[] = {
 
 
 /**
- * 16-bit word version of `libkeccak_f_round`
+ * Rotate a 16-bit word by a rotation offset for 64-bit words
+ * 
+ * @param   x:uint16_t  The value to rotate
+ * @param   n:long int  Rotation steps for a 64-bit word, the
+ *                      remainder modulo 16 may not be zero
+ * @return   :uint16_t  The value rotated
+ */
+#define rotate16_64(x, n) rotate16(x, (n) % 16L)
+
+
+/**
+ * Defined if the SSSE3 kernels for 16-bit words are selected
+ * at compile time, the scalar kernels are then only needed
+ * for the fallback of the 16-way kernel
+ */
+#if defined(__SSSE3__) && !defined(__BMI__)
+# define SSSE3_KERNELS16 1
+#endif
+
+
+#if !defined(SSSE3_KERNELS16) || !defined(__AVX2__)
+/**
+ * 16-bit word version of `libkeccak_f`
  * 
  * @param  state  The hashing state
- * @param  rc     The round contant for this round
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
 static void
-libkeccak_f_round16(register struct libkeccak_state *state, register uint16_t rc)
+libkeccak_f16(register struct libkeccak_state *state)
 {
-	uint16_t *restrict A = state->S.w16;
-	uint16_t B[25], C[5], da, db, dc, dd, de;
-
-	/* θ step (step 1 of 3). */
-#define X(N) C[N] = A[N * 5] ^ A[N * 5 + 1] ^ A[N * 5 + 2] ^ A[N * 5 + 3] ^ A[N * 5 + 4]
-	LIST_5(X, ;);
-#undef X
+	KECCAK_F(state->S.w16, uint16_t, state->nr, &rc16[20 - state->nr], rotate16_64, CHI_DEFAULT);
+}
+#endif
 
-	/* θ step (step 2 of 3). */
-	da = C[4] ^ rotate16(C[1], 1);
-	dd = C[2] ^ rotate16(C[4], 1);
-	db = C[0] ^ rotate16(C[2], 1);
-	de = C[3] ^ rotate16(C[0], 1);
-	dc = C[1] ^ rotate16(C[3], 1);
-
-	/* ρ and π steps, with last two part of θ. */
-#define X(bi, ai, dv, r) B[bi] = rotate16(A[ai] ^ dv, r)
-	B[0] = A[0] ^ da;   X( 1, 15, dd, 12);  X( 2,  5, db,  1);  X( 3, 20, de, 11);  X( 4, 10, dc, 14);
-	X( 5,  6, db, 12);  X( 6, 21, de,  4);  X( 7, 11, dc,  6);  X( 8,  1, da,  4);  X( 9, 16, dd,  7);
-	X(10, 12, dc, 11);  X(11,  2, da,  3);  X(12, 17, dd,  9);  X(13,  7, db, 10);  X(14, 22, de,  7);
-	X(15, 18, dd,  5);  X(16,  8, db, 13);  X(17, 23, de,  8);  X(18, 13, dc, 15);  X(19,  3, da,  9);
-	X(20, 24, de, 14);  X(21, 14, dc, 13);  X(22,  4, da,  2);  X(23, 19, dd,  8);  X(24,  9, db,  2);
-#undef X
 
-	/* ξ step. */
-#define X(N) A[N] = (uint16_t)(B[N] ^ ((~(B[(N + 5) % 25])) & B[(N + 10) % 25]))
-	LIST_25(X, ;);
-#undef X
-
-	/* ι step. */
-	A[0] ^= rc;
+#if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_f16` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_f16_bmi(register struct libkeccak_state *state)
+{
+	KECCAK_F(state->S.w16, uint16_t, state->nr, &rc16[20 - state->nr], rotate16_64, ANDN);
 }
+#endif
 
 
 /**
@@ -89,3 +96,424 @@ libkeccak_to_lane16(register const unsigned char *message, register size_t msgle
 #undef X
 	return rc;
 }
+
+
+/**
+ * Read a 16-bit lane stored in little endian,
+ * the lane does not need to be aligned
+ * 
+ * @param   message  The lane's location in the message
+ * @return           The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint16_t
+libkeccak_load16(register const unsigned char *message)
+{
+#if defined(HOST_LITTLE_ENDIAN)
+	uint16_t rc;
+	__builtin_memcpy(&rc, message, sizeof(rc));
+	return rc;
+#elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	uint16_t rc;
+	__builtin_memcpy(&rc, message, sizeof(rc));
+	return __builtin_bswap16(rc);
+#else
+	return (uint16_t)(message[0] | (message[1] << 8));
+#endif
+}
+
+
+/**
+ * 16-bit lane version of `libkeccak_absorb_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  message  The block to absorb, must be at least `rr` bytes
+ * @param  rr       Bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_absorb_block16(register uint16_t *restrict S, register const unsigned char *restrict message, register long int rr)
+{
+	register long int i, n = rr >> 1;
+	for (i = 0; i < n; i++)
+		S[i] ^= libkeccak_load16(&message[i * 2]);
+	if (rr & 1)
+		S[n] ^= libkeccak_to_lane16(message, (size_t)rr, rr, (size_t)(n * 2));
+}
+
+
+/**
+ * Store a 16-bit lane in little endian,
+ * the lane does not need to be aligned
+ * 
+ * @param  message  The lane's location in the output
+ * @param  value    The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_store16(register unsigned char *message, uint16_t value)
+{
+#if defined(HOST_LITTLE_ENDIAN)
+	__builtin_memcpy(message, &value, sizeof(value));
+#elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	value = __builtin_bswap16(value);
+	__builtin_memcpy(message, &value, sizeof(value));
+#else
+	message[0] = (unsigned char)value;
+	message[1] = (unsigned char)(value >> 8);
+#endif
+}
+
+
+/**
+ * 16-bit lane version of `libkeccak_squeeze_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_squeeze_block16(register const uint16_t *restrict S, register unsigned char *restrict hashsum, register long int len)
+{
+	register long int i, n = len / 2;
+	register uint16_t v;
+	for (i = 0; i < n; i++)
+		libkeccak_store16(&hashsum[i * 2], S[i]);
+	hashsum += n * 2;
+	len -= n * 2;
+	for (v = S[n]; len--; v >>= 8)
+		*hashsum++ = (unsigned char)v;
+}
+
+
+#if !defined(SSSE3_KERNELS16)
+/**
+ * Absorb whole blocks into a sponge with 16-bit lanes,
+ * and permute the sponge after each block
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb16(register struct libkeccak_state *restrict state,
+                   register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block16(state->S.w16, message, rr);
+		KECCAK_F(state->S.w16, uint16_t, state->nr, &rc16[20 - state->nr], rotate16_64, CHI_DEFAULT);
+	}
+}
+#endif
+
+
+#if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_absorb16` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_absorb16_bmi(register struct libkeccak_state *restrict state,
+                       register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block16(state->S.w16, message, rr);
+		KECCAK_F(state->S.w16, uint16_t, state->nr, &rc16[20 - state->nr], rotate16_64, ANDN);
+	}
+}
+#endif
+
+
+/**
+ * Output at most one block from a sponge with 16-bit lanes
+ * 
+ * @param  state    The hashing state
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_squeeze16(register const struct libkeccak_state *restrict state,
+                    register unsigned char *restrict hashsum, register long int len)
+{
+	libkeccak_squeeze_block16(state->S.w16, hashsum, len);
+}
+
+
+#if defined(__SSSE3__) || defined(HAVE_X86_DISPATCH)
+# include <immintrin.h>
+
+
+/**
+ * Create a shuffle control for `_mm_shuffle_epi8` that moves
+ * 16-bit words, word 5, 6, and 7 of the output are set to zero
+ * 
+ * @param   a, b, c, d, e  The input word for each of the output word 0 to 4
+ * @return  :__m128i        The shuffle control
+ */
+# define SHUFFLE16(a, b, c, d, e)\
+	_mm_setr_epi8(2 * (a), 2 * (a) + 1, 2 * (b), 2 * (b) + 1, 2 * (c), 2 * (c) + 1,\
+	              2 * (d), 2 * (d) + 1, 2 * (e), 2 * (e) + 1, -128, -128, -128, -128, -128, -128)
+
+/**
+ * Create a multiplier vector for `libkeccak_rotate_rows16`
+ * 
+ * @param   w              The lane size
+ * @param   a, b, c, d, e  The rotation offsets, for 64-bit
+ *                         lanes, of the lanes in the row
+ * @return  :__m128i       The multipliers
+ */
+# define ROTATION16(w, a, b, c, d, e)\
+	_mm_setr_epi16((short)(1U << ((a) % (w))), (short)(1U << ((b) % (w))), (short)(1U << ((c) % (w))),\
+	               (short)(1U << ((d) % (w))), (short)(1U << ((e) % (w))), 0, 0, 0)
+
+
+/**
+ * 16 set bytes followed by 16 cleared bytes, for creating
+ * masks that select the first bytes of a vector
+ */
+static const unsigned char libkeccak_byte_mask_window[32] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+
+/**
+ * Rotate each 16-bit word (for 16-bit lanes), or the lower half of
+ * each 16-bit word (for 8-bit lanes, the upper halves must be cleared)
+ * 
+ * @param   x  The words
+ * @param   w  The lane size, 16 or 8
+ * @param   m  The multipliers, see `ROTATION16`
+ * @return     The words rotated
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nothrow__, __const__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline __m128i
+libkeccak_rotate_rows16(__m128i x, long int w, __m128i m)
+{
+	if (w == 8) {
+		x = _mm_mullo_epi16(x, m);
+		return _mm_and_si128(_mm_or_si128(x, _mm_srli_epi16(x, 8)), _mm_set1_epi16(0x00FF));
+	}
+	return _mm_or_si128(_mm_mullo_epi16(x, m), _mm_mulhi_epu16(x, m));
+}
+
+
+/**
+ * Rotate each 16-bit word (for 16-bit lanes), or the lower half of
+ * each 16-bit word (for 8-bit lanes, the upper halves must be cleared),
+ * by one step
+ * 
+ * @param   x  The words
+ * @param   w  The lane size, 16 or 8
+ * @return     The words rotated
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nothrow__, __const__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline __m128i
+libkeccak_rotate1_rows16(__m128i x, long int w)
+{
+	if (w == 8)
+		return _mm_and_si128(_mm_or_si128(_mm_slli_epi16(x, 1), _mm_srli_epi16(x, 7)), _mm_set1_epi16(0x00FF));
+	return _mm_or_si128(_mm_slli_epi16(x, 1), _mm_srli_epi16(x, 15));
+}
+
+
+/**
+ * Keccak-f for 16-bit and 8-bit lanes, with the sponge held in
+ * five SSE registers, one for each row (plane), with one 16-bit
+ * word per lane (for 8-bit lanes, the upper half of the words
+ * are kept cleared)
+ * 
+ * ρ is performed with multiplications by powers of 2, π by
+ * shuffling the lanes in each row with `_mm_shuffle_epi8`,
+ * which turns the rows into columns, so that χ needs no
+ * shuffling, and the columns are then transposed back
+ * into rows
+ * 
+ * @param  R   The rows, word `x` of `R[y]` is lane (x, y),
+ *             words 5 to 7 are ignored
+ * @param  nr  The number of rounds, the last `nr` of the
+ *             20 or 18 rounds of Keccak-f are performed
+ * @param  w   The word size, 16 or 8
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline void
+libkeccak_f_rows16_ssse3(register __m128i *restrict R, register long int nr, register long int w)
+{
+	__m128i r0 = R[0], r1 = R[1], r2 = R[2], r3 = R[3], r4 = R[4];
+	__m128i c, d, t0, t1, t2, t3, u0, u1, u2;
+	long int i, end = w == 8 ? 18 : 20;
+
+	for (i = end - nr; i < end; i++) {
+		/* θ step. */
+		c = _mm_xor_si128(_mm_xor_si128(_mm_xor_si128(r0, r1), _mm_xor_si128(r2, r3)), r4);
+		d = _mm_shuffle_epi8(c, SHUFFLE16(1, 2, 3, 4, 0));
+		d = _mm_xor_si128(_mm_shuffle_epi8(c, SHUFFLE16(4, 0, 1, 2, 3)), libkeccak_rotate1_rows16(d, w));
+		r0 = _mm_xor_si128(r0, d);
+		r1 = _mm_xor_si128(r1, d);
+		r2 = _mm_xor_si128(r2, d);
+		r3 = _mm_xor_si128(r3, d);
+		r4 = _mm_xor_si128(r4, d);
+
+		/* ρ and π steps: afterwards, word k of register x is
+		 * lane (x, k), that is, the registers hold columns
+		 * rather than rows. Lane (x, k) comes from row x,
+		 * column (3k + x) mod 5. */
+		r0 = _mm_shuffle_epi8(libkeccak_rotate_rows16(r0, w, ROTATION16(w,  0,  1, 62, 28, 27)), SHUFFLE16(0, 3, 1, 4, 2));
+		r1 = _mm_shuffle_epi8(libkeccak_rotate_rows16(r1, w, ROTATION16(w, 36, 44,  6, 55, 20)), SHUFFLE16(1, 4, 2, 0, 3));
+		r2 = _mm_shuffle_epi8(libkeccak_rotate_rows16(r2, w, ROTATION16(w,  3, 10, 43, 25, 39)), SHUFFLE16(2, 0, 3, 1, 4));
+		r3 = _mm_shuffle_epi8(libkeccak_rotate_rows16(r3, w, ROTATION16(w, 41, 45, 15, 21,  8)), SHUFFLE16(3, 1, 4, 2, 0));
+		r4 = _mm_shuffle_epi8(libkeccak_rotate_rows16(r4, w, ROTATION16(w, 18,  2, 61, 56, 14)), SHUFFLE16(4, 2, 0, 3, 1));
+
+		/* χ step, on the columns. */
+		t0 = _mm_xor_si128(r0, _mm_andnot_si128(r1, r2));
+		t1 = _mm_xor_si128(r1, _mm_andnot_si128(r2, r3));
+		t2 = _mm_xor_si128(r2, _mm_andnot_si128(r3, r4));
+		t3 = _mm_xor_si128(r3, _mm_andnot_si128(r4, r0));
+		r4 = _mm_xor_si128(r4, _mm_andnot_si128(r0, r1));
+
+		/* ι step. */
+		t0 = _mm_xor_si128(t0, _mm_cvtsi32_si128(w == 8 ? rc16[i] & 0xFF : rc16[i]));
+
+		/* Transpose the columns back into rows. */
+		r0 = _mm_unpacklo_epi16(t0, t1);
+		r1 = _mm_unpackhi_epi16(t0, t1);
+		r2 = _mm_unpacklo_epi16(t2, t3);
+		r3 = _mm_unpackhi_epi16(t2, t3);
+		u0 = _mm_unpacklo_epi32(r0, r2);
+		u1 = _mm_unpackhi_epi32(r0, r2);
+		u2 = _mm_unpacklo_epi32(r1, r3);
+		r0 = _mm_unpacklo_epi64(u0, r4);
+		r1 = _mm_unpackhi_epi64(u0, _mm_slli_si128(r4, 6));
+		r2 = _mm_unpacklo_epi64(u1, _mm_srli_si128(r4, 4));
+		r3 = _mm_unpackhi_epi64(u1, _mm_slli_si128(r4, 2));
+		r4 = _mm_unpacklo_epi64(u2, _mm_srli_si128(r4, 8));
+	}
+
+	R[0] = r0;
+	R[1] = r1;
+	R[2] = r2;
+	R[3] = r3;
+	R[4] = r4;
+}
+
+
+/**
+ * Load at most 16 bytes, and clear the rest of the vector
+ * 
+ * @param   message  The bytes to load
+ * @param   n        The number of bytes to load, at most 16
+ * @param   avail    The number of bytes that may be read from `message`
+ * @return           The bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline __m128i
+libkeccak_load_partial_ssse3(register const unsigned char *message, register size_t n, register size_t avail)
+{
+	unsigned char buf[16];
+	if (__builtin_expect(avail >= 16, 1))
+		return _mm_and_si128(_mm_loadu_si128((const void *)message),
+		                     _mm_loadu_si128((const void *)&libkeccak_byte_mask_window[16 - n]));
+	__builtin_memset(buf, 0, sizeof(buf));
+	__builtin_memcpy(buf, message, n);
+	return _mm_loadu_si128((const void *)buf);
+}
+
+
+/**
+ * Load the rows of a sponge with 16-bit lanes
+ * 
+ * @param  R  Output parameter for the rows, see `libkeccak_f_rows16_ssse3`
+ * @param  S  The lanes of the sponge, must be followed by at least 6 bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline void
+libkeccak_load_rows16_ssse3(register __m128i *restrict R, register const uint16_t *restrict S)
+{
+# define X(N) R[N] = _mm_loadu_si128((const void *)&S[N * 5])
+	LIST_5(X, ;);
+# undef X
+}
+
+
+/**
+ * Store the rows of a sponge with 16-bit lanes
+ * 
+ * @param  S  Output parameter for the lanes of the sponge
+ * @param  R  The rows, see `libkeccak_f_rows16_ssse3`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__, __target__("ssse3"))))
+static inline void
+libkeccak_store_rows16_ssse3(register uint16_t *restrict S, register const __m128i *restrict R)
+{
+	/* Each store overwrites the beginning of the next row, which is then stored. */
+	_mm_storeu_si128((void *)&S[0 * 5], R[0]);
+	_mm_storeu_si128((void *)&S[1 * 5], R[1]);
+	_mm_storeu_si128((void *)&S[2 * 5], R[2]);
+	_mm_storeu_si128((void *)&S[3 * 5], R[3]);
+	_mm_storel_epi64((void *)&S[4 * 5], R[4]);
+	S[24] = (uint16_t)_mm_extract_epi16(R[4], 4);
+}
+
+
+# if defined(HAVE_X86_DISPATCH) || !defined(__BMI__)
+
+
+/**
+ * Version of `libkeccak_f16` for CPUs with SSSE3
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("ssse3"))))
+static void
+libkeccak_f16_ssse3(register struct libkeccak_state *state)
+{
+	__m128i R[5];
+	libkeccak_load_rows16_ssse3(R, state->S.w16);
+	libkeccak_f_rows16_ssse3(R, state->nr, 16);
+	libkeccak_store_rows16_ssse3(state->S.w16, R);
+}
+
+
+/**
+ * Version of `libkeccak_absorb16` for CPUs with SSSE3,
+ * the sponge is kept in registers between the blocks
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("ssse3"))))
+static void
+libkeccak_absorb16_ssse3(register struct libkeccak_state *restrict state,
+                         register const unsigned char *restrict message, register size_t n)
+{
+	register size_t rr = (size_t)(state->r >> 3);
+	const unsigned char *end = &message[n * rr];
+	__m128i R[5];
+
+	libkeccak_load_rows16_ssse3(R, state->S.w16);
+	for (; n--; message += rr) {
+# define X(N)\
+		if (rr > N * 10)\
+			R[N] = _mm_xor_si128(R[N], libkeccak_load_partial_ssse3(&message[N * 10], rr - N * 10 < 10 ? rr - N * 10 : 10,\
+			                                                        (size_t)(end - &message[N * 10])))
+		LIST_5(X, ;);
+# undef X
+		libkeccak_f_rows16_ssse3(R, state->nr, 16);
+	}
+	libkeccak_store_rows16_ssse3(state->S.w16, R);
+}
+
+
+# endif
+
+
+#endif
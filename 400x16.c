@@ -0,0 +1,103 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/*
+ * The sponges processed by the functions in this file are stored
+ * interleaved, such that lane N of sponge K is stored at index
+ * `N * 16 + K`, this way one lane from all sixteen sponges can be
+ * loaded into one 256-bit register.
+ */
+
+
+#if defined(__AVX2__) || defined(HAVE_X86_DISPATCH)
+# include <immintrin.h>
+
+
+/**
+ * Rotate sixteen 16-bit words
+ *
+ * @param   x:__m256i   The values to rotate
+ * @param   n:long int  Rotation steps for a 64-bit word,
+ *                      the remainder modulo 16 may not be zero
+ * @return   :__m256i   The values rotated
+ */
+# define rotate16x16(x, n) _mm256_or_si256(_mm256_slli_epi16((x), (n) % 16), _mm256_srli_epi16((x), 16 - (n) % 16))
+
+
+/**
+ * 16-way 16-bit word version of `libkeccak_f`, for CPUs with AVX2
+ *
+ * @param  S   The interleaved lanes of the sixteen sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("avx2"))))
+static void
+libkeccak_f16x16_avx2(register uint16_t *restrict S, register long int nr)
+{
+	__m256i A[25];
+	long int i;
+
+# define X(N) A[N] = _mm256_loadu_si256((const void *)&S[N * 16])
+	LIST_25(X, ;);
+# undef X
+
+	for (i = 20 - nr; i < 20; i++)
+		KECCAK_ROUND_AVX2(A, rotate16x16, _mm256_set1_epi16((short int)rc16[i]));
+
+# define X(N) _mm256_storeu_si256((void *)&S[N * 16], A[N])
+	LIST_25(X, ;);
+# undef X
+}
+
+
+#endif
+
+
+#if defined(__AVX2__)
+
+
+/**
+ * 16-way 16-bit word version of `libkeccak_f`
+ *
+ * @param  S   The interleaved lanes of the sixteen sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+# define libkeccak_f16x16 libkeccak_f16x16_avx2
+
+
+#else
+
+
+/**
+ * 16-way 16-bit word version of `libkeccak_f`
+ *
+ * This is the fallback used when AVX2 is not available,
+ * and simply permutes the sixteen sponges one at a time
+ *
+ * @param  S   The interleaved lanes of the sixteen sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f16x16(register uint16_t *restrict S, register long int nr)
+{
+	struct libkeccak_state state;
+	long int k;
+
+	state.nr = nr;
+	for (k = 0; k < 16; k++) {
+# define X(N) state.S.w16[N] = S[N * 16 + k]
+		LIST_25(X, ;);
+# undef X
+		libkeccak_f16(&state);
+# define X(N) S[N * 16 + k] = (uint16_t)state.S.w16[N]
+		LIST_25(X, ;);
+# undef X
+	}
+}
+
+
+#endif
@@ -25,47 +25,42 @@ static const uint32_t rc32[] = {
 
 
 /**
- * 32-bit word version of `libkeccak_f_round`
+ * Rotate a 32-bit word by a rotation offset for 64-bit words
+ * 
+ * @param   x:uint32_t  The value to rotate
+ * @param   n:long int  Rotation steps for a 64-bit word, the
+ *                      remainder modulo 32 may not be zero
+ * @return   :uint32_t  The value rotated
+ */
+#define rotate32_64(x, n) rotate32(x, (n) % 32L)
+
+
+/**
+ * 32-bit word version of `libkeccak_f`
  * 
  * @param  state  The hashing state
- * @param  rc     The round contant for this round
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
 static void
-libkeccak_f_round32(register struct libkeccak_state *state, register uint32_t rc)
+libkeccak_f32(register struct libkeccak_state *state)
 {
-	uint32_t *restrict A = state->S.w32;
-	uint32_t B[25], C[5], da, db, dc, dd, de;
-
-	/* θ step (step 1 of 3). */
-#define X(N) C[N] = A[N * 5] ^ A[N * 5 + 1] ^ A[N * 5 + 2] ^ A[N * 5 + 3] ^ A[N * 5 + 4]
-	LIST_5(X, ;);
-#undef X
-
-	/* θ step (step 2 of 3). */
-	da = C[4] ^ rotate32(C[1], 1);
-	dd = C[2] ^ rotate32(C[4], 1);
-	db = C[0] ^ rotate32(C[2], 1);
-	de = C[3] ^ rotate32(C[0], 1);
-	dc = C[1] ^ rotate32(C[3], 1);
-
-	/* ρ and π steps, with last two part of θ. */
-#define X(bi, ai, dv, r) B[bi] = rotate32(A[ai] ^ dv, r)
-	B[0] = A[0] ^ da;   X( 1, 15, dd, 28);  X( 2,  5, db,  1);  X( 3, 20, de, 27);  X( 4, 10, dc, 30);
-	X( 5,  6, db, 12);  X( 6, 21, de, 20);  X( 7, 11, dc,  6);  X( 8,  1, da,  4);  X( 9, 16, dd, 23);
-	X(10, 12, dc, 11);  X(11,  2, da,  3);  X(12, 17, dd, 25);  X(13,  7, db, 10);  X(14, 22, de,  7);
-	X(15, 18, dd, 21);  X(16,  8, db, 13);  X(17, 23, de,  8);  X(18, 13, dc, 15);  X(19,  3, da,  9);
-	X(20, 24, de, 14);  X(21, 14, dc, 29);  X(22,  4, da, 18);  X(23, 19, dd, 24);  X(24,  9, db,  2);
-#undef X
+	KECCAK_F(state->S.w32, uint32_t, state->nr, &rc32[22 - state->nr], rotate32_64, CHI_DEFAULT);
+}
 
-	/* ξ step. */
-#define X(N) A[N] = (uint32_t)(B[N] ^ ((~(B[(N + 5) % 25])) & B[(N + 10) % 25]))
-	LIST_25(X, ;);
-#undef X
 
-	/* ι step. */
-	A[0] ^= rc;
+#if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_f32` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_f32_bmi(register struct libkeccak_state *state)
+{
+	KECCAK_F(state->S.w32, uint32_t, state->nr, &rc32[22 - state->nr], rotate32_64, ANDN);
 }
+#endif
 
 
 /**
@@ -90,3 +85,156 @@ libkeccak_to_lane32(register const unsigned char *message, register size_t msgle
 #undef X
 	return rc;
 }
+
+
+/**
+ * Read a 32-bit lane stored in little endian,
+ * the lane does not need to be aligned
+ * 
+ * @param   message  The lane's location in the message
+ * @return           The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __hot__, __warn_unused_result__, __gnu_inline__)))
+static inline uint32_t
+libkeccak_load32(register const unsigned char *message)
+{
+#if defined(HOST_LITTLE_ENDIAN)
+	uint32_t rc;
+	__builtin_memcpy(&rc, message, sizeof(rc));
+	return rc;
+#elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	uint32_t rc;
+	__builtin_memcpy(&rc, message, sizeof(rc));
+	return __builtin_bswap32(rc);
+#else
+	uint32_t rc = 0;
+# define X(N) rc |= (uint32_t)message[N] << (N * 8)
+	LIST_4(X, ;);
+# undef X
+	return rc;
+#endif
+}
+
+
+/**
+ * 32-bit lane version of `libkeccak_absorb_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  message  The block to absorb, must be at least `rr` bytes
+ * @param  rr       Bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_absorb_block32(register uint32_t *restrict S, register const unsigned char *restrict message, register long int rr)
+{
+	register long int i, n = rr >> 2;
+	for (i = 0; i < n; i++)
+		S[i] ^= libkeccak_load32(&message[i * 4]);
+	if (rr & 3)
+		S[n] ^= libkeccak_to_lane32(message, (size_t)rr, rr, (size_t)(n * 4));
+}
+
+
+/**
+ * Store a 32-bit lane in little endian,
+ * the lane does not need to be aligned
+ * 
+ * @param  message  The lane's location in the output
+ * @param  value    The lane
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_store32(register unsigned char *message, uint32_t value)
+{
+#if defined(HOST_LITTLE_ENDIAN)
+	__builtin_memcpy(message, &value, sizeof(value));
+#elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	value = __builtin_bswap32(value);
+	__builtin_memcpy(message, &value, sizeof(value));
+#else
+# define X(N) message[N] = (unsigned char)(value >> (N * 8))
+	LIST_4(X, ;);
+# undef X
+#endif
+}
+
+
+/**
+ * 32-bit lane version of `libkeccak_squeeze_block`
+ * 
+ * @param  S        The lanes of the sponge
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __gnu_inline__)))
+static inline void
+libkeccak_squeeze_block32(register const uint32_t *restrict S, register unsigned char *restrict hashsum, register long int len)
+{
+	register long int i, n = len / 4;
+	register uint32_t v;
+	for (i = 0; i < n; i++)
+		libkeccak_store32(&hashsum[i * 4], S[i]);
+	hashsum += n * 4;
+	len -= n * 4;
+	for (v = S[n]; len--; v >>= 8)
+		*hashsum++ = (unsigned char)v;
+}
+
+
+/**
+ * Absorb whole blocks into a sponge with 32-bit lanes,
+ * and permute the sponge after each block
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb32(register struct libkeccak_state *restrict state,
+                   register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block32(state->S.w32, message, rr);
+		KECCAK_F(state->S.w32, uint32_t, state->nr, &rc32[22 - state->nr], rotate32_64, CHI_DEFAULT);
+	}
+}
+
+
+#if defined(HAVE_X86_DISPATCH)
+/**
+ * Version of `libkeccak_absorb32` for CPUs with BMI1 and BMI2
+ * 
+ * @param  state    The hashing state
+ * @param  message  The blocks to absorb
+ * @param  n        The number of blocks to absorb
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("bmi,bmi2"))))
+static void
+libkeccak_absorb32_bmi(register struct libkeccak_state *restrict state,
+                       register const unsigned char *restrict message, register size_t n)
+{
+	register long int rr = state->r >> 3;
+	for (; n--; message += (size_t)rr) {
+		libkeccak_absorb_block32(state->S.w32, message, rr);
+		KECCAK_F(state->S.w32, uint32_t, state->nr, &rc32[22 - state->nr], rotate32_64, ANDN);
+	}
+}
+#endif
+
+
+/**
+ * Output at most one block from a sponge with 32-bit lanes
+ * 
+ * @param  state    The hashing state
+ * @param  hashsum  Output buffer, must be at least `len` bytes
+ * @param  len      The number of bytes to output, at most the bitrate in bytes
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_squeeze32(register const struct libkeccak_state *restrict state,
+                    register unsigned char *restrict hashsum, register long int len)
+{
+	libkeccak_squeeze_block32(state->S.w32, hashsum, len);
+}
@@ -0,0 +1,103 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/*
+ * The sponges processed by the functions in this file are stored
+ * interleaved, such that lane N of sponge K is stored at index
+ * `N * 8 + K`, this way one lane from all eight sponges can be
+ * loaded into one 256-bit register.
+ */
+
+
+#if defined(__AVX2__) || defined(HAVE_X86_DISPATCH)
+# include <immintrin.h>
+
+
+/**
+ * Rotate eight 32-bit words
+ *
+ * @param   x:__m256i   The values to rotate
+ * @param   n:long int  Rotation steps for a 64-bit word,
+ *                      the remainder modulo 32 may not be zero
+ * @return   :__m256i   The values rotated
+ */
+# define rotate32x8(x, n) _mm256_or_si256(_mm256_slli_epi32((x), (n) % 32), _mm256_srli_epi32((x), 32 - (n) % 32))
+
+
+/**
+ * 8-way 32-bit word version of `libkeccak_f`, for CPUs with AVX2
+ *
+ * @param  S   The interleaved lanes of the eight sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__, __target__("avx2"))))
+static void
+libkeccak_f32x8_avx2(register uint32_t *restrict S, register long int nr)
+{
+	__m256i A[25];
+	long int i;
+
+# define X(N) A[N] = _mm256_loadu_si256((const void *)&S[N * 8])
+	LIST_25(X, ;);
+# undef X
+
+	for (i = 22 - nr; i < 22; i++)
+		KECCAK_ROUND_AVX2(A, rotate32x8, _mm256_set1_epi32((int)rc32[i]));
+
+# define X(N) _mm256_storeu_si256((void *)&S[N * 8], A[N])
+	LIST_25(X, ;);
+# undef X
+}
+
+
+#endif
+
+
+#if defined(__AVX2__)
+
+
+/**
+ * 8-way 32-bit word version of `libkeccak_f`
+ *
+ * @param  S   The interleaved lanes of the eight sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+# define libkeccak_f32x8 libkeccak_f32x8_avx2
+
+
+#else
+
+
+/**
+ * 8-way 32-bit word version of `libkeccak_f`
+ *
+ * This is the fallback used when AVX2 is not available,
+ * and simply permutes the eight sponges one at a time
+ *
+ * @param  S   The interleaved lanes of the eight sponges
+ * @param  nr  The number of rounds, the last `nr` rounds of
+ *             Keccak-f are performed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f32x8(register uint32_t *restrict S, register long int nr)
+{
+	struct libkeccak_state state;
+	long int k;
+
+	state.nr = nr;
+	for (k = 0; k < 8; k++) {
+# define X(N) state.S.w32[N] = S[N * 8 + k]
+		LIST_25(X, ;);
+# undef X
+		libkeccak_f32(&state);
+# define X(N) S[N * 8 + k] = (uint32_t)state.S.w32[N]
+		LIST_25(X, ;);
+# undef X
+	}
+}
+
+
+#endif
@@ -0,0 +1,34 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Block to absorb into idle lanes
+ */
+static const unsigned char zero_block[200];
+
+
+/**
+ * Absorb the same number of whole blocks into each state
+ * in a batch, the states are permuted after each block
+ * 
+ * @param  batch  The batch
+ * @param  msgs   The message to absorb into each state
+ * @param  len    The number of bytes to absorb into each
+ *                state, must be a multiple of `batch->r / 8`
+ */
+void
+libkeccak_state_batch_absorb(struct libkeccak_state_batch *restrict batch, const void *const *restrict msgs, size_t len)
+{
+	const unsigned char *block[MAX_WAYS];
+	size_t rr = (size_t)(batch->r >> 3);
+	size_t i, j, k;
+
+	for (i = 0; i < batch->count; i += batch->ways) {
+		for (j = 0; j < len; j += rr) {
+			for (k = 0; k < batch->ways; k++)
+				block[k] = i + k < batch->count ? &((const unsigned char *)msgs[i + k])[j] : zero_block;
+			batch->multi->absorb(BATCH_SPONGES(batch, i), block, (long int)rr, batch->nr);
+		}
+	}
+}
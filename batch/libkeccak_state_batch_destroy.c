@@ -0,0 +1,20 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Release resources allocation for a batch of states
+ * and wipe sensitive data
+ * 
+ * @param  batch  The batch that should be destroyed, may be `NULL`
+ */
+void
+libkeccak_state_batch_destroy(struct libkeccak_state_batch *batch)
+{
+	if (batch && batch->S.w8) {
+		my_explicit_bzero(batch->S.w8, (batch->count + batch->ways - 1) / batch->ways * sizeof(union libkeccak_multi_sponge));
+		free(batch->S.w8);
+		batch->S.w8 = NULL;
+	}
+}
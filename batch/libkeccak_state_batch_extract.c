@@ -0,0 +1,24 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Copy a state out of a batch of states
+ * 
+ * @param  batch  The batch
+ * @param  k      The index of the state in the batch
+ * @param  state  Output parameter for the state, will be
+ *                initialised with the batch's specifications
+ */
+void
+libkeccak_state_batch_extract(const struct libkeccak_state_batch *restrict batch, size_t k,
+                              struct libkeccak_state *restrict state)
+{
+	struct libkeccak_spec spec;
+
+	spec.bitrate = batch->r;
+	spec.capacity = batch->c;
+	spec.output = batch->n;
+	libkeccak_state_initialise(state, &spec);
+	batch->multi->extract(state, BATCH_SPONGES(batch, k), (long int)(k % batch->ways));
+}
@@ -0,0 +1,46 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Initialise a batch of states according to hashing specifications
+ * 
+ * @param   batch  The batch that should be initialised
+ * @param   spec   The specifications for the states
+ * @param   count  The number of states, must not be 0
+ * @return         Zero on success, -1 on error
+ */
+int
+libkeccak_state_batch_initialise(struct libkeccak_state_batch *restrict batch, const struct libkeccak_spec *restrict spec,
+                                 size_t count)
+{
+	size_t blocks;
+	long int x;
+
+	if (!count || libkeccak_spec_check(spec)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	batch->r = spec->bitrate;
+	batch->c = spec->capacity;
+	batch->n = spec->output;
+	batch->b = batch->r + batch->c;
+	batch->w = batch->b / 25;
+	for (batch->nr = 12, x = batch->w; x > 1; x >>= 1)
+		batch->nr += 2;
+	batch->multi = libkeccak_get_multi(batch->w);
+	if (!batch->multi) {
+		errno = EINVAL;
+		return -1;
+	}
+	batch->count = count;
+	batch->ways = (size_t)batch->multi->ways;
+
+	blocks = (count + batch->ways - 1) / batch->ways;
+	batch->S.w8 = calloc(blocks, sizeof(union libkeccak_multi_sponge));
+	if (!batch->S.w8)
+		return -1;
+
+	return 0;
+}
@@ -0,0 +1,24 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Copy a state into a batch of states
+ * 
+ * @param   batch  The batch
+ * @param   k      The index of the state in the batch
+ * @param   state  The state to copy, must have the same bitrate and
+ *                 capacity as the batch and no buffered message
+ * @return         Zero on success, -1 on error
+ */
+int
+libkeccak_state_batch_insert(struct libkeccak_state_batch *restrict batch, size_t k,
+                             const struct libkeccak_state *restrict state)
+{
+	if (k >= batch->count || state->r != batch->r || state->c != batch->c || state->nr != batch->nr || state->mptr) {
+		errno = EINVAL;
+		return -1;
+	}
+	batch->multi->insert(BATCH_SPONGES(batch, k), state, (long int)(k % batch->ways));
+	return 0;
+}
@@ -0,0 +1,16 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Perform the Keccak-f permutation on each state in a batch
+ * 
+ * @param  batch  The batch
+ */
+void
+libkeccak_state_batch_permute(struct libkeccak_state_batch *batch)
+{
+	size_t i;
+	for (i = 0; i < batch->count; i += batch->ways)
+		batch->multi->permute(BATCH_SPONGES(batch, i), batch->nr);
+}
@@ -0,0 +1,15 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Reset the states in a batch
+ * 
+ * @param  batch  The batch that should be reset
+ */
+void
+libkeccak_state_batch_reset(struct libkeccak_state_batch *batch)
+{
+	size_t blocks = (batch->count + batch->ways - 1) / batch->ways;
+	__builtin_memset(batch->S.w8, 0, blocks * sizeof(union libkeccak_multi_sponge));
+}
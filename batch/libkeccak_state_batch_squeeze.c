@@ -0,0 +1,27 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Squeeze `batch->n` bits out of each state in a batch, the
+ * states are permuted between blocks but not before the first
+ * block, so the first call should follow the absorption of the
+ * padded last block, and subsequent calls should be preceded
+ * by a call to `libkeccak_state_batch_permute`
+ * 
+ * @param  batch     The batch
+ * @param  hashsums  Output parameter for the hashsum of each state,
+ *                   an element may be `NULL` to discard that output
+ */
+void
+libkeccak_state_batch_squeeze(struct libkeccak_state_batch *restrict batch, void *const *restrict hashsums)
+{
+	unsigned char *out[MAX_WAYS];
+	size_t i, k;
+
+	for (i = 0; i < batch->count; i += batch->ways) {
+		for (k = 0; k < batch->ways; k++)
+			out[k] = i + k < batch->count ? hashsums[i + k] : NULL;
+		batch->multi->squeeze(BATCH_SPONGES(batch, i), batch->r, batch->n, batch->nr, out);
+	}
+}
@@ -92,10 +92,17 @@ main(void)
 	spec.bitrate = BITRATE;
 	spec.capacity = CAPACITY;
 	spec.output = OUTPUT;
+#ifdef ROUNDS
+	if (libkeccak_state_initialise_rounds(&state, &spec, ROUNDS)) {
+		perror("libkeccak_state_initialise_rounds");
+		return 1;
+	}
+#else
 	if (libkeccak_state_initialise(&state, &spec)) {
 		perror("libkeccak_state_initialise");
 		return 1;
 	}
+#endif
 
 	/* Get start-time. */
 	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &start) < 0) {
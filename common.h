@@ -19,6 +19,7 @@
 # endif
 #endif
 #include <errno.h>
+#include <pthread.h>
 #include <unistd.h>
 
 
@@ -32,6 +33,14 @@
 #endif
 
 
+/* Detect the host's byte order, if possible */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define HOST_LITTLE_ENDIAN 1
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+# define HOST_BIG_ENDIAN 1
+#endif
+
+
 /**
  * Literal comma that can be passed as a macro argument
  */
@@ -88,6 +97,875 @@
 	X(20) D X(21) D X(22) D X(23) D X(24)
 
 
+/**
+ * Copy the lanes of a sponge held in local variables
+ * to another set of local variables
+ * 
+ * @param  O  The prefix of the variables to copy to
+ * @param  I  The prefix of the variables to copy from
+ */
+#define COPY_LANES(O, I)\
+	O##0 = I##0;   O##1 = I##1;   O##2 = I##2;   O##3 = I##3;   O##4 = I##4;\
+	O##5 = I##5;   O##6 = I##6;   O##7 = I##7;   O##8 = I##8;   O##9 = I##9;\
+	O##10 = I##10; O##11 = I##11; O##12 = I##12; O##13 = I##13; O##14 = I##14;\
+	O##15 = I##15; O##16 = I##16; O##17 = I##17; O##18 = I##18; O##19 = I##19;\
+	O##20 = I##20; O##21 = I##21; O##22 = I##22; O##23 = I##23; O##24 = I##24
+
+/**
+ * Complement the lanes that are stored complemented by the
+ * in-register Keccak-f kernels that use the lane complementing
+ * transform to compute χ (`CHI` is `COMPLEMENTED`); kernels that
+ * use ANDN (`CHI` is `ANDN`) do not complement any lane
+ * 
+ * @param  T  The word type
+ * @param  V  The prefix of the variables holding the lanes
+ */
+#define COMPLEMENT_LANES_ANDN(T, V)
+#define COMPLEMENT_LANES_COMPLEMENTED(T, V)\
+	V##1 = (T)~V##1; V##2 = (T)~V##2; V##8 = (T)~V##8;\
+	V##12 = (T)~V##12; V##17 = (T)~V##17; V##20 = (T)~V##20
+
+/**
+ * χ step for one plane of lanes in the in-register Keccak-f kernels
+ * 
+ * The input is in the variables `P##b0`, ..., `P##b4`. The `ANDN`
+ * version is written to be compiled to ANDN instructions; the
+ * `COMPLEMENTED` version works on complemented lanes (see
+ * `COMPLEMENT_LANES_COMPLEMENTED`) and has its own formulas for
+ * each plane so that only one NOT is needed per plane
+ * 
+ * @param  T                   The word type
+ * @param  P                   The prefix of the temporaries, may be empty
+ * @param  o0, o1, o2, o3, o4  The output lanes
+ */
+#define CHI_ANDN_PLANE(T, P, o0, o1, o2, o3, o4)\
+	o0 = (T)(P##b0 ^ (~P##b1 & P##b2));\
+	o1 = (T)(P##b1 ^ (~P##b2 & P##b3));\
+	o2 = (T)(P##b2 ^ (~P##b3 & P##b4));\
+	o3 = (T)(P##b3 ^ (~P##b4 & P##b0));\
+	o4 = (T)(P##b4 ^ (~P##b0 & P##b1))
+#define CHI_ANDN_PLANE0 CHI_ANDN_PLANE
+#define CHI_ANDN_PLANE1 CHI_ANDN_PLANE
+#define CHI_ANDN_PLANE2 CHI_ANDN_PLANE
+#define CHI_ANDN_PLANE3 CHI_ANDN_PLANE
+#define CHI_ANDN_PLANE4 CHI_ANDN_PLANE
+#define CHI_COMPLEMENTED_PLANE0(T, P, o0, o1, o2, o3, o4)\
+	o0 = (T)(P##b0 ^ (P##b1 | P##b2));\
+	o1 = (T)(P##b1 ^ (~P##b2 | P##b3));\
+	o2 = (T)(P##b2 ^ (P##b3 & P##b4));\
+	o3 = (T)(P##b3 ^ (P##b4 | P##b0));\
+	o4 = (T)(P##b4 ^ (P##b0 & P##b1))
+#define CHI_COMPLEMENTED_PLANE1(T, P, o0, o1, o2, o3, o4)\
+	o0 = (T)(P##b0 ^ (P##b1 | P##b2));\
+	o1 = (T)(P##b1 ^ (P##b2 & P##b3));\
+	o2 = (T)(P##b2 ^ (P##b3 | ~P##b4));\
+	o3 = (T)(P##b3 ^ (P##b4 | P##b0));\
+	o4 = (T)(P##b4 ^ (P##b0 & P##b1))
+#define CHI_COMPLEMENTED_PLANE2(T, P, o0, o1, o2, o3, o4)\
+	o0 = (T)(P##b0 ^ (P##b1 | P##b2));\
+	o1 = (T)(P##b1 ^ (P##b2 & P##b3));\
+	o2 = (T)(P##b2 ^ (~P##b3 & P##b4));\
+	o3 = (T)(~P##b3 ^ (P##b4 | P##b0));\
+	o4 = (T)(P##b4 ^ (P##b0 & P##b1))
+#define CHI_COMPLEMENTED_PLANE3(T, P, o0, o1, o2, o3, o4)\
+	o0 = (T)(P##b0 ^ (P##b1 & P##b2));\
+	o1 = (T)(P##b1 ^ (P##b2 | P##b3));\
+	o2 = (T)(P##b2 ^ (~P##b3 | P##b4));\
+	o3 = (T)(~P##b3 ^ (P##b4 & P##b0));\
+	o4 = (T)(P##b4 ^ (P##b0 | P##b1))
+#define CHI_COMPLEMENTED_PLANE4(T, P, o0, o1, o2, o3, o4)\
+	o0 = (T)(P##b0 ^ (~P##b1 & P##b2));\
+	o1 = (T)(~P##b1 ^ (P##b2 | P##b3));\
+	o2 = (T)(P##b2 ^ (P##b3 & P##b4));\
+	o3 = (T)(P##b3 ^ (P##b4 | P##b0));\
+	o4 = (T)(P##b4 ^ (P##b0 & P##b1))
+
+/**
+ * The χ version to use for kernels that are not compiled
+ * for a specific CPU: ANDN is only worth it if the compiler
+ * is allowed to emit ANDN instructions
+ */
+#if defined(__BMI__)
+# define CHI_DEFAULT ANDN
+#else
+# define CHI_DEFAULT COMPLEMENTED
+#endif
+
+/**
+ * One round of Keccak-f on a sponge held in local variables
+ * 
+ * Lane N of the input is in the variable `I##N`, and lane
+ * N of the output is written to `O##N`; the variables `c0`,
+ * ..., `c4`, `da`, ..., `de` and `b0`, ..., `b4` are used as
+ * temporaries. The rotation offsets are those for 64-bit
+ * words, `ROT` must reduce them modulo the word size
+ * 
+ * @param  ROT  `ROT(x, n)` shall rotate `x` by `n` steps
+ * @param  T    The word type
+ * @param  CHI  The χ version, `ANDN` or `COMPLEMENTED`
+ * @param  I    The prefix of the input variables
+ * @param  O    The prefix of the output variables
+ * @param  rc   The round constant
+ */
+#define KECCAK_ROUND(ROT, T, CHI, I, O, rc)\
+	do {\
+		KECCAK_ROUND_THETA_(ROT, T, I, );\
+		KECCAK_ROUND_PLANE0_(ROT, T, CHI, I, O, , rc);\
+		KECCAK_ROUND_PLANE1_(ROT, T, CHI, I, O, );\
+		KECCAK_ROUND_PLANE2_(ROT, T, CHI, I, O, );\
+		KECCAK_ROUND_PLANE3_(ROT, T, CHI, I, O, );\
+		KECCAK_ROUND_PLANE4_(ROT, T, CHI, I, O, );\
+	} while (0)
+
+/**
+ * One round of Keccak-f on two sponges held in local variables,
+ * with the steps for the two sponges interleaved so that the
+ * CPU has two independent dependency chains to work on
+ * 
+ * This is `KECCAK_ROUND` for the sponge in `I` and `O`, using
+ * temporaries prefixed with `x`, and for the sponge in `J`
+ * and `Q`, using temporaries prefixed with `y`
+ * 
+ * @param  ROT  See `KECCAK_ROUND`
+ * @param  T    The word type
+ * @param  CHI  The χ version, `ANDN` or `COMPLEMENTED`
+ * @param  I    The prefix of the input variables for the first sponge
+ * @param  O    The prefix of the output variables for the first sponge
+ * @param  J    The prefix of the input variables for the second sponge
+ * @param  Q    The prefix of the output variables for the second sponge
+ * @param  rc   The round constant
+ */
+#define KECCAK_ROUND2(ROT, T, CHI, I, O, J, Q, rc)\
+	do {\
+		KECCAK_ROUND_THETA_(ROT, T, I, x);\
+		KECCAK_ROUND_THETA_(ROT, T, J, y);\
+		KECCAK_ROUND_PLANE0_(ROT, T, CHI, I, O, x, rc);\
+		KECCAK_ROUND_PLANE0_(ROT, T, CHI, J, Q, y, rc);\
+		KECCAK_ROUND_PLANE1_(ROT, T, CHI, I, O, x);\
+		KECCAK_ROUND_PLANE1_(ROT, T, CHI, J, Q, y);\
+		KECCAK_ROUND_PLANE2_(ROT, T, CHI, I, O, x);\
+		KECCAK_ROUND_PLANE2_(ROT, T, CHI, J, Q, y);\
+		KECCAK_ROUND_PLANE3_(ROT, T, CHI, I, O, x);\
+		KECCAK_ROUND_PLANE3_(ROT, T, CHI, J, Q, y);\
+		KECCAK_ROUND_PLANE4_(ROT, T, CHI, I, O, x);\
+		KECCAK_ROUND_PLANE4_(ROT, T, CHI, J, Q, y);\
+	} while (0)
+
+#define KECCAK_ROUND_THETA_(ROT, T, I, P)\
+	P##c0 = (T)(I##0 ^ I##5 ^ I##10 ^ I##15 ^ I##20);\
+	P##c1 = (T)(I##1 ^ I##6 ^ I##11 ^ I##16 ^ I##21);\
+	P##c2 = (T)(I##2 ^ I##7 ^ I##12 ^ I##17 ^ I##22);\
+	P##c3 = (T)(I##3 ^ I##8 ^ I##13 ^ I##18 ^ I##23);\
+	P##c4 = (T)(I##4 ^ I##9 ^ I##14 ^ I##19 ^ I##24);\
+	P##da = (T)(P##c4 ^ ROT(P##c1, 1));\
+	P##db = (T)(P##c0 ^ ROT(P##c2, 1));\
+	P##dc = (T)(P##c1 ^ ROT(P##c3, 1));\
+	P##dd = (T)(P##c2 ^ ROT(P##c4, 1));\
+	P##de = (T)(P##c3 ^ ROT(P##c0, 1))
+#define KECCAK_ROUND_PLANE0_(ROT, T, CHI, I, O, P, rc)\
+	P##b0 = (T)(I##0 ^ P##da);            P##b1 = ROT(I##6 ^ P##db, 44);\
+	P##b2 = ROT(I##12 ^ P##dc, 43);       P##b3 = ROT(I##18 ^ P##dd, 21);\
+	P##b4 = ROT(I##24 ^ P##de, 14);\
+	CHI_##CHI##_PLANE0(T, P, O##0, O##1, O##2, O##3, O##4);\
+	O##0 ^= (T)(rc)
+#define KECCAK_ROUND_PLANE1_(ROT, T, CHI, I, O, P)\
+	P##b0 = ROT(I##3 ^ P##dd, 28);        P##b1 = ROT(I##9 ^ P##de, 20);\
+	P##b2 = ROT(I##10 ^ P##da, 3);        P##b3 = ROT(I##16 ^ P##db, 45);\
+	P##b4 = ROT(I##22 ^ P##dc, 61);\
+	CHI_##CHI##_PLANE1(T, P, O##5, O##6, O##7, O##8, O##9)
+#define KECCAK_ROUND_PLANE2_(ROT, T, CHI, I, O, P)\
+	P##b0 = ROT(I##1 ^ P##db, 1);         P##b1 = ROT(I##7 ^ P##dc, 6);\
+	P##b2 = ROT(I##13 ^ P##dd, 25);       P##b3 = ROT(I##19 ^ P##de, 8);\
+	P##b4 = ROT(I##20 ^ P##da, 18);\
+	CHI_##CHI##_PLANE2(T, P, O##10, O##11, O##12, O##13, O##14)
+#define KECCAK_ROUND_PLANE3_(ROT, T, CHI, I, O, P)\
+	P##b0 = ROT(I##4 ^ P##de, 27);        P##b1 = ROT(I##5 ^ P##da, 36);\
+	P##b2 = ROT(I##11 ^ P##db, 10);       P##b3 = ROT(I##17 ^ P##dc, 15);\
+	P##b4 = ROT(I##23 ^ P##dd, 56);\
+	CHI_##CHI##_PLANE3(T, P, O##15, O##16, O##17, O##18, O##19)
+#define KECCAK_ROUND_PLANE4_(ROT, T, CHI, I, O, P)\
+	P##b0 = ROT(I##2 ^ P##dc, 62);        P##b1 = ROT(I##8 ^ P##dd, 55);\
+	P##b2 = ROT(I##14 ^ P##de, 39);       P##b3 = ROT(I##15 ^ P##da, 41);\
+	P##b4 = ROT(I##21 ^ P##db, 2);\
+	CHI_##CHI##_PLANE4(T, P, O##20, O##21, O##22, O##23, O##24)
+
+/**
+ * Body of an in-register Keccak-f kernel
+ * 
+ * The sponge is kept in local variables through all rounds,
+ * and two rounds are performed per iteration, alternating
+ * between two sets of variables; if the number of rounds
+ * is odd, the first round is performed on its own
+ * 
+ * @param  S    The lanes of the sponge, `T *`
+ * @param  T    The word type
+ * @param  NR   The number of rounds
+ * @param  RC   The round constants, `(RC)[0]` is used for the first round
+ * @param  ROT  See `KECCAK_ROUND`
+ * @param  CHI  The χ version, `ANDN`, `COMPLEMENTED`, or `CHI_DEFAULT`
+ */
+#define KECCAK_F(S, T, NR, RC, ROT, CHI) KECCAK_F_(S, T, NR, RC, ROT, CHI)
+#define KECCAK_F_(S, T, NR, RC, ROT, CHI)\
+	do {\
+		T *restrict lanes__ = (S);\
+		T a0 = lanes__[0], a1 = lanes__[1], a2 = lanes__[2], a3 = lanes__[3], a4 = lanes__[4];\
+		T a5 = lanes__[5], a6 = lanes__[6], a7 = lanes__[7], a8 = lanes__[8], a9 = lanes__[9];\
+		T a10 = lanes__[10], a11 = lanes__[11], a12 = lanes__[12], a13 = lanes__[13], a14 = lanes__[14];\
+		T a15 = lanes__[15], a16 = lanes__[16], a17 = lanes__[17], a18 = lanes__[18], a19 = lanes__[19];\
+		T a20 = lanes__[20], a21 = lanes__[21], a22 = lanes__[22], a23 = lanes__[23], a24 = lanes__[24];\
+		T e0, e1, e2, e3, e4, e5, e6, e7, e8, e9, e10, e11, e12;\
+		T e13, e14, e15, e16, e17, e18, e19, e20, e21, e22, e23, e24;\
+		T b0, b1, b2, b3, b4, c0, c1, c2, c3, c4, da, db, dc, dd, de;\
+		long int i__ = 0;\
+		COMPLEMENT_LANES_##CHI(T, a);\
+		if ((NR) & 1) {\
+			KECCAK_ROUND(ROT, T, CHI, a, e, (RC)[0]);\
+			COPY_LANES(a, e);\
+			i__ = 1;\
+		}\
+		for (; i__ < (NR); i__ += 2) {\
+			KECCAK_ROUND(ROT, T, CHI, a, e, (RC)[i__]);\
+			KECCAK_ROUND(ROT, T, CHI, e, a, (RC)[i__ + 1]);\
+		}\
+		COMPLEMENT_LANES_##CHI(T, a);\
+		lanes__[0] = a0;   lanes__[1] = a1;   lanes__[2] = a2;   lanes__[3] = a3;   lanes__[4] = a4;\
+		lanes__[5] = a5;   lanes__[6] = a6;   lanes__[7] = a7;   lanes__[8] = a8;   lanes__[9] = a9;\
+		lanes__[10] = a10; lanes__[11] = a11; lanes__[12] = a12; lanes__[13] = a13; lanes__[14] = a14;\
+		lanes__[15] = a15; lanes__[16] = a16; lanes__[17] = a17; lanes__[18] = a18; lanes__[19] = a19;\
+		lanes__[20] = a20; lanes__[21] = a21; lanes__[22] = a22; lanes__[23] = a23; lanes__[24] = a24;\
+	} while (0)
+
+
+/**
+ * Body of an in-register Keccak-f kernel for two sponges,
+ * see `KECCAK_F` and `KECCAK_ROUND2`
+ * 
+ * @param  S1   The lanes of the first sponge, `T *`
+ * @param  S2   The lanes of the second sponge, `T *`
+ * @param  T    The word type
+ * @param  NR   The number of rounds
+ * @param  RC   The round constants, `(RC)[0]` is used for the first round
+ * @param  ROT  See `KECCAK_ROUND`
+ * @param  CHI  The χ version, `ANDN`, `COMPLEMENTED`, or `CHI_DEFAULT`
+ */
+#define KECCAK_F2(S1, S2, T, NR, RC, ROT, CHI) KECCAK_F2_(S1, S2, T, NR, RC, ROT, CHI)
+#define KECCAK_F2_(S1, S2, T, NR, RC, ROT, CHI)\
+	do {\
+		T *restrict lanes1__ = (S1);\
+		T *restrict lanes2__ = (S2);\
+		T a0 = lanes1__[0], a1 = lanes1__[1], a2 = lanes1__[2], a3 = lanes1__[3], a4 = lanes1__[4];\
+		T a5 = lanes1__[5], a6 = lanes1__[6], a7 = lanes1__[7], a8 = lanes1__[8], a9 = lanes1__[9];\
+		T a10 = lanes1__[10], a11 = lanes1__[11], a12 = lanes1__[12], a13 = lanes1__[13], a14 = lanes1__[14];\
+		T a15 = lanes1__[15], a16 = lanes1__[16], a17 = lanes1__[17], a18 = lanes1__[18], a19 = lanes1__[19];\
+		T a20 = lanes1__[20], a21 = lanes1__[21], a22 = lanes1__[22], a23 = lanes1__[23], a24 = lanes1__[24];\
+		T u0 = lanes2__[0], u1 = lanes2__[1], u2 = lanes2__[2], u3 = lanes2__[3], u4 = lanes2__[4];\
+		T u5 = lanes2__[5], u6 = lanes2__[6], u7 = lanes2__[7], u8 = lanes2__[8], u9 = lanes2__[9];\
+		T u10 = lanes2__[10], u11 = lanes2__[11], u12 = lanes2__[12], u13 = lanes2__[13], u14 = lanes2__[14];\
+		T u15 = lanes2__[15], u16 = lanes2__[16], u17 = lanes2__[17], u18 = lanes2__[18], u19 = lanes2__[19];\
+		T u20 = lanes2__[20], u21 = lanes2__[21], u22 = lanes2__[22], u23 = lanes2__[23], u24 = lanes2__[24];\
+		T e0, e1, e2, e3, e4, e5, e6, e7, e8, e9, e10, e11, e12;\
+		T e13, e14, e15, e16, e17, e18, e19, e20, e21, e22, e23, e24;\
+		T v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12;\
+		T v13, v14, v15, v16, v17, v18, v19, v20, v21, v22, v23, v24;\
+		T xb0, xb1, xb2, xb3, xb4, xc0, xc1, xc2, xc3, xc4, xda, xdb, xdc, xdd, xde;\
+		T yb0, yb1, yb2, yb3, yb4, yc0, yc1, yc2, yc3, yc4, yda, ydb, ydc, ydd, yde;\
+		long int i__ = 0;\
+		COMPLEMENT_LANES_##CHI(T, a);\
+		COMPLEMENT_LANES_##CHI(T, u);\
+		if ((NR) & 1) {\
+			KECCAK_ROUND2(ROT, T, CHI, a, e, u, v, (RC)[0]);\
+			COPY_LANES(a, e);\
+			COPY_LANES(u, v);\
+			i__ = 1;\
+		}\
+		for (; i__ < (NR); i__ += 2) {\
+			KECCAK_ROUND2(ROT, T, CHI, a, e, u, v, (RC)[i__]);\
+			KECCAK_ROUND2(ROT, T, CHI, e, a, v, u, (RC)[i__ + 1]);\
+		}\
+		COMPLEMENT_LANES_##CHI(T, a);\
+		COMPLEMENT_LANES_##CHI(T, u);\
+		lanes1__[0] = a0;   lanes1__[1] = a1;   lanes1__[2] = a2;   lanes1__[3] = a3;   lanes1__[4] = a4;\
+		lanes1__[5] = a5;   lanes1__[6] = a6;   lanes1__[7] = a7;   lanes1__[8] = a8;   lanes1__[9] = a9;\
+		lanes1__[10] = a10; lanes1__[11] = a11; lanes1__[12] = a12; lanes1__[13] = a13; lanes1__[14] = a14;\
+		lanes1__[15] = a15; lanes1__[16] = a16; lanes1__[17] = a17; lanes1__[18] = a18; lanes1__[19] = a19;\
+		lanes1__[20] = a20; lanes1__[21] = a21; lanes1__[22] = a22; lanes1__[23] = a23; lanes1__[24] = a24;\
+		lanes2__[0] = u0;   lanes2__[1] = u1;   lanes2__[2] = u2;   lanes2__[3] = u3;   lanes2__[4] = u4;\
+		lanes2__[5] = u5;   lanes2__[6] = u6;   lanes2__[7] = u7;   lanes2__[8] = u8;   lanes2__[9] = u9;\
+		lanes2__[10] = u10; lanes2__[11] = u11; lanes2__[12] = u12; lanes2__[13] = u13; lanes2__[14] = u14;\
+		lanes2__[15] = u15; lanes2__[16] = u16; lanes2__[17] = u17; lanes2__[18] = u18; lanes2__[19] = u19;\
+		lanes2__[20] = u20; lanes2__[21] = u21; lanes2__[22] = u22; lanes2__[23] = u23; lanes2__[24] = u24;\
+	} while (0)
+
+/**
+ * Whether kernels for specific x86 extensions are compiled,
+ * to be selected at runtime; add -DDISABLE_RUNTIME_DISPATCH
+ * to CPPFLAGS to only compile the kernels selected by CFLAGS
+ */
+#if !defined(DISABLE_RUNTIME_DISPATCH) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define HAVE_X86_DISPATCH 1
+#endif
+
+
+/**
+ * Whether Keccak-f[1600] shall be performed on bit-interleaved
+ * lanes (64-bit lanes split into two 32-bit words), which is
+ * faster on 32-bit CPUs; by default, this is used when pointers
+ * are 32 bits wide, add -DBIT_INTERLEAVED_1600=0 or
+ * -DBIT_INTERLEAVED_1600=1 to CPPFLAGS to override this
+ */
+#if !defined(BIT_INTERLEAVED_1600)
+# if UINTPTR_MAX <= UINT32_MAX
+#  define BIT_INTERLEAVED_1600 1
+# else
+#  define BIT_INTERLEAVED_1600 0
+# endif
+#endif
+
+/**
+ * Whether pairs of Keccak-f[1600] sponges shall be permuted
+ * with the instructions for the two sponges interleaved
+ * (see `KECCAK_F2`) rather than one after the other; this
+ * is off by default because the extra register pressure
+ * makes it slower on x86-64, add -DINTERLEAVED_PAIRS=1
+ * to CPPFLAGS to turn it on
+ */
+#if !defined(INTERLEAVED_PAIRS)
+# define INTERLEAVED_PAIRS 0
+#endif
+
+
+/**
+ * The permutation, absorb and squeeze routines for
+ * one word size, pointed to by `struct libkeccak_state`
+ */
+struct libkeccak_kernels {
+	/**
+	 * Perform the Keccak-f permutation on the sponge
+	 */
+	void (*f)(struct libkeccak_state *);
+
+	/**
+	 * Absorb whole blocks, and permute
+	 * the sponge after each block
+	 */
+	void (*absorb)(struct libkeccak_state *restrict, const unsigned char *restrict, size_t);
+
+	/**
+	 * Output at most one block from the sponge,
+	 * without permuting it
+	 */
+	void (*squeeze)(const struct libkeccak_state *restrict, unsigned char *restrict, long int);
+
+	/**
+	 * Perform the Keccak-f permutation on two sponges
+	 */
+	void (*f_pair)(struct libkeccak_state *restrict, struct libkeccak_state *restrict);
+
+	/**
+	 * Absorb the same number of whole blocks into
+	 * two sponges with the same bitrate, and permute
+	 * the sponges after each block
+	 */
+	void (*absorb_pair)(struct libkeccak_state *restrict, const unsigned char *restrict,
+	                    struct libkeccak_state *restrict, const unsigned char *restrict, size_t);
+};
+
+
+/**
+ * Get the kernels for a word size
+ * 
+ * @param   w  The word size, 64, 32, 16, or 8
+ * @return     The kernels, `NULL` if `w` is invalid
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __const__, __nothrow__, __warn_unused_result__)))
+const struct libkeccak_kernels *libkeccak_get_kernels(long int w);
+
+
+/**
+ * Interleaved sponges for the multi-buffer kernels, see
+ * 1600x4.c, 800x8.c, 400x16.c, and 200x32.c; every
+ * word size fills the same 25 256-bit vectors
+ */
+union libkeccak_multi_sponge {
+	uint64_t w64[25 * 4];
+	uint32_t w32[25 * 8];
+	uint16_t w16[25 * 16];
+	uint8_t w8[25 * 32];
+};
+
+
+/**
+ * The largest number of interleaved sponges
+ */
+#define MAX_WAYS 32
+
+
+/**
+ * Functions for processing interleaved sponges
+ */
+struct libkeccak_multi {
+	/**
+	 * The number of sponges
+	 */
+	long int ways;
+
+	/**
+	 * Absorb one block into each sponge, and permute them
+	 * 
+	 * @param  S         The sponges
+	 * @param  messages  The block to absorb into each sponge
+	 * @param  rr        The bitrate in bytes
+	 * @param  nr        The number of rounds
+	 */
+	void (*absorb)(union libkeccak_multi_sponge *restrict, const unsigned char *const *restrict, long int, long int);
+
+	/**
+	 * Perform the squeezing phase on each sponge
+	 * 
+	 * @param  S          The sponges
+	 * @param  r          The bitrate
+	 * @param  n          The output size
+	 * @param  nr         The number of rounds
+	 * @param  hashsums   Output parameters for the hashsums, `NULL` for
+	 *                    sponges whose output shall be discarded
+	 */
+	void (*squeeze)(union libkeccak_multi_sponge *restrict, long int, long int, long int, unsigned char *const *restrict);
+
+	/**
+	 * Copy one of the sponges into a state
+	 * 
+	 * @param  state  The state to copy the sponge into
+	 * @param  S      The sponges
+	 * @param  k      The index of the sponge to copy
+	 */
+	void (*extract)(struct libkeccak_state *restrict, const union libkeccak_multi_sponge *restrict, long int);
+
+	/**
+	 * Reset one of the sponges to all zeroes
+	 * 
+	 * @param  S  The sponges
+	 * @param  k  The index of the sponge to reset
+	 */
+	void (*clear)(union libkeccak_multi_sponge *restrict, long int);
+
+	/**
+	 * Copy a state's sponge into one of the sponges
+	 * 
+	 * @param  S      The sponges
+	 * @param  state  The state to copy the sponge from
+	 * @param  k      The index of the sponge to overwrite
+	 */
+	void (*insert)(union libkeccak_multi_sponge *restrict, const struct libkeccak_state *restrict, long int);
+
+	/**
+	 * Permute each sponge
+	 * 
+	 * @param  S   The sponges
+	 * @param  nr  The number of rounds
+	 */
+	void (*permute)(union libkeccak_multi_sponge *restrict, long int);
+};
+
+
+/**
+ * Get the functions for processing interleaved sponges
+ * 
+ * @param   w  The word size
+ * @return     The functions, `NULL` if there are no
+ *             multi-buffer kernels for the word size
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __const__, __nothrow__, __warn_unused_result__)))
+const struct libkeccak_multi *libkeccak_get_multi(long int w);
+
+
+/**
+ * Perform the squeezing phase
+ * 
+ * @param  state    The hashing state
+ * @param  rr       The bitrate in bytes
+ * @param  nn       The output size in bytes, rounded up to whole bytes
+ * @param  hashsum  Output parameter for the hashsum
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__, __nothrow__, __hot__)))
+void libkeccak_squeezing_phase(struct libkeccak_state *restrict, long int, long int, unsigned char *restrict);
+
+
+/**
+ * Copy the last part of a message to a buffer, and
+ * append the suffix and a 10*1-pad to it
+ * 
+ * @param   r           Should be `state->r` where `state` is the hashing state
+ * @param   buf         Output buffer, must have room for `msglen` bytes, the
+ *                      suffix, and the pad, which may extend into another block
+ * @param   msg         The rest of the message, may be `NULL` if `msglen` and `bits` are 0
+ * @param   msglen      The number of whole bytes in `msg`, should be less than `r / 8`
+ * @param   bits        The number of bits at the end of `msg` that does not make a whole byte
+ * @param   suffix      The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
+ * @param   suffix_len  The number of bits in `suffix`
+ * @return              The length of the padded message, a multiple of `r / 8`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__(2), __nothrow__)))
+size_t libkeccak_pad_final(size_t, unsigned char *restrict, const unsigned char *restrict, size_t,
+                           size_t, const char *restrict, size_t);
+
+
+/**
+ * Copy a state, of the message buffer, `.M`, which
+ * is the last member of the state, only the part
+ * that is in use is copied
+ * 
+ * @param  dest  The state to overwrite
+ * @param  src   The state to copy
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static inline void
+libkeccak_state_copy_buffered(struct libkeccak_state *restrict dest, const struct libkeccak_state *restrict src)
+{
+	memcpy(dest, src, offsetof(struct libkeccak_state, M) + src->mptr);
+}
+
+
+/**
+ * Copy a state that has no buffered message
+ * 
+ * The message buffer, `.M`, is the last member of the
+ * state and is not copied, so `src` must not have any
+ * buffered message, that is, `src->mptr` must be 0;
+ * this is the case for sponges that are only kept to
+ * be copied, such as a sponge with a key or the
+ * cSHAKE initialisation blocks absorbed
+ * 
+ * @param  dest  The state to overwrite
+ * @param  src   The state to copy, `src->mptr` must be 0
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static inline void
+libkeccak_state_copy_unbuffered(struct libkeccak_state *restrict dest, const struct libkeccak_state *restrict src)
+{
+	memcpy(dest, src, offsetof(struct libkeccak_state, M));
+}
+
+
+/**
+ * The number of groups of lanes in a job manager, jobs whose
+ * sponges cannot be permuted together use different groups
+ */
+#define JOB_GROUPS 4
+
+
+/**
+ * Interleaved sponges for jobs with the same word size,
+ * bitrate, and number of rounds
+ */
+struct libkeccak_job_group {
+	/**
+	 * The functions for processing the sponges,
+	 * `NULL` if the group is not in use
+	 */
+	const struct libkeccak_multi *multi;
+
+	/**
+	 * The bitrate of the sponges
+	 */
+	long int r;
+
+	/**
+	 * The number of rounds
+	 */
+	long int nr;
+
+	/**
+	 * The number of lanes that have a job
+	 */
+	size_t active;
+
+	/**
+	 * The job in each lane, `NULL` for idle lanes
+	 */
+	struct libkeccak_job *job[MAX_WAYS];
+
+	/**
+	 * The number of whole blocks in each lane's message
+	 */
+	size_t full[MAX_WAYS];
+
+	/**
+	 * The total number of blocks to absorb in each lane,
+	 * including the padded blocks in `.pad`
+	 */
+	size_t blocks[MAX_WAYS];
+
+	/**
+	 * The number of blocks absorbed in each lane
+	 */
+	size_t next[MAX_WAYS];
+
+	/**
+	 * The padded end of each lane's message
+	 */
+	unsigned char pad[MAX_WAYS][2 * 200];
+
+	/**
+	 * The sponges, the sponges of idle lanes
+	 * are cleared when they get a job
+	 */
+	union libkeccak_multi_sponge S;
+};
+
+
+/**
+ * Multi-buffer job manager
+ */
+struct libkeccak_job_manager {
+	/**
+	 * The first completed job that has not been returned
+	 */
+	struct libkeccak_job *completed;
+
+	/**
+	 * The last completed job that has not been returned
+	 */
+	struct libkeccak_job *completed_last;
+
+	/**
+	 * The groups of lanes
+	 */
+	struct libkeccak_job_group groups[JOB_GROUPS];
+};
+
+
+/**
+ * Add a job to the queue of completed jobs
+ * 
+ * @param  manager  The job manager
+ * @param  job      The completed job
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__, __nothrow__)))
+void libkeccak_job_complete(struct libkeccak_job_manager *restrict, struct libkeccak_job *restrict);
+
+
+/**
+ * Process the jobs in a group until at least one of them
+ * completes, and move completed jobs to the queue of
+ * completed jobs; idle lanes absorb blocks of zeroes
+ * 
+ * @param  manager  The job manager
+ * @param  group    The group, must have at least one job
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__, __nothrow__, __hot__)))
+void libkeccak_job_group_run(struct libkeccak_job_manager *restrict, struct libkeccak_job_group *restrict);
+
+
+/**
+ * Get the interleaved sponges that a state in a batch is stored in
+ * 
+ * @param   batch  The batch
+ * @param   k      The index of the state in the batch
+ * @return         The sponges of the block that state `k` belongs to
+ */
+#define BATCH_SPONGES(batch, k)\
+	((union libkeccak_multi_sponge *)(void *)&(batch)->S.w8[(k) / (batch)->ways * sizeof(union libkeccak_multi_sponge)])
+
+
+/**
+ * Pool of threads that run the tasks of one job at a time
+ */
+struct libkeccak_worker_pool {
+	/**
+	 * Protects all members except `.run_mutex`, `.threads`,
+	 * and `.nthreads`
+	 */
+	pthread_mutex_t mutex;
+
+	/**
+	 * Signalled when tasks are added or the threads shall stop
+	 */
+	pthread_cond_t work_cond;
+
+	/**
+	 * Signalled when the last running task completes
+	 */
+	pthread_cond_t done_cond;
+
+	/**
+	 * Held by `libkeccak_worker_pool_run` so that
+	 * only one job is run at a time
+	 */
+	pthread_mutex_t run_mutex;
+
+	/**
+	 * The threads
+	 */
+	pthread_t *threads;
+
+	/**
+	 * The number of threads in `.threads`, the thread
+	 * that calls `libkeccak_worker_pool_run` is not counted
+	 */
+	size_t nthreads;
+
+	/**
+	 * The function that runs a task of the current job
+	 * 
+	 * @param  data  `.data`
+	 * @param  i     The index of the task
+	 */
+	void (*func)(void *, size_t);
+
+	/**
+	 * The first argument for `.func`
+	 */
+	void *data;
+
+	/**
+	 * The index of the next task to start
+	 */
+	size_t next;
+
+	/**
+	 * The number of tasks in the current job
+	 */
+	size_t count;
+
+	/**
+	 * The number of tasks being run
+	 */
+	size_t busy;
+
+	/**
+	 * Whether the threads shall stop
+	 */
+	int quit;
+};
+
+
+/**
+ * Run `func(data, i)` for each `i` in [0, `count`), spread
+ * over the threads in a worker pool and the calling thread,
+ * and wait for all of them to complete
+ * 
+ * @param  pool   The worker pool, `NULL` to run all tasks in the calling thread
+ * @param  func   The function that runs a task
+ * @param  data   The first argument for `func`
+ * @param  count  The number of tasks
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__(2))))
+void libkeccak_worker_pool_run(struct libkeccak_worker_pool *, void (*)(void *, size_t), void *, size_t);
+
+
+/**
+ * The number of leaves passed to `libkeccak_digest_many`
+ * or `libkeccak_digest_many_rounds` at a time by `libkeccak_worker_pool_hash_leaves`
+ */
+#define LEAVES_PER_BATCH 8
+
+/**
+ * The number of tasks per thread that
+ * `libkeccak_worker_pool_hash_leaves` splits the
+ * leaves into, so that the threads finish together
+ */
+#define TASKS_PER_THREAD 4
+
+/**
+ * Hash independent leaves of a message, with the
+ * multi-buffer kernels and the threads of a worker pool
+ * 
+ * @param  pool      The worker pool, may be `NULL`
+ * @param  spec      The specifications for the leaves
+ * @param  rounds    The number of rounds, 0 for all rounds of Keccak-f
+ * @param  suffix    The message suffix for the leaves
+ * @param  data      The leaves, concatenated
+ * @param  len       The number of bytes in `data`, only the last leaf may be partial
+ * @param  leafsize  The size of a leaf, in bytes
+ * @param  cvs       Output buffer for the chaining values, concatenated,
+ *                   each `(spec->output + 7) / 8` bytes long
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__(2, 4, 5, 8))))
+void libkeccak_worker_pool_hash_leaves(struct libkeccak_worker_pool *, const struct libkeccak_spec *, long int,
+                                       const char *, const void *, size_t, size_t, void *);
+
+
+/**
+ * The number of KangarooTwelve chunks that are
+ * collected, per thread, before they are hashed
+ */
+#define K12_CHUNKS_PER_THREAD 32
+
+/**
+ * Hash KangarooTwelve leaves and absorb their
+ * chaining values into the final node
+ * 
+ * @param   state  The hashing state
+ * @param   data   The chunks, all but the last must be whole
+ * @param   len    The number of bytes in `data`
+ * @return         Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__)))
+int libkeccak_k12_hash_leaves(struct libkeccak_k12_state *restrict, const unsigned char *restrict, size_t);
+
+
+/**
+ * The cSHAKE function name for KMAC
+ */
+#define KMAC_FUNCTION_NAME "KMAC"
+
+/**
+ * The cSHAKE function name for TupleHash
+ */
+#define TUPLEHASH_FUNCTION_NAME "TupleHash"
+
+/**
+ * The cSHAKE function name for ParallelHash
+ */
+#define PARALLELHASH_FUNCTION_NAME "ParallelHash"
+
+
+/**
+ * The number of bytes of ParallelHash blocks that are
+ * collected, per thread, before they are hashed
+ */
+#define PARALLELHASH_BYTES_PER_THREAD (256UL << 10)
+
+/**
+ * Whether a ParallelHash hashing state collects
+ * its blocks in `.buffer`, rather than absorbing
+ * each block into `.leaf`
+ * 
+ * @param   STATE:const struct libkeccak_parallelhash_state *  The hashing state
+ * @return  :int                                               Whether blocks are collected
+ */
+#define PARALLELHASH_BUFFERED(STATE) ((STATE)->blocksize <= PARALLELHASH_BYTES_PER_THREAD)
+
+/**
+ * The maximum number of ParallelHash blocks that
+ * are collected, per thread, before they are hashed
+ */
+#define PARALLELHASH_MAX_BLOCKS_PER_THREAD 4096
+
+/**
+ * Hash ParallelHash blocks and absorb their
+ * chaining values into the final node
+ * 
+ * @param   state  The hashing state
+ * @param   data   The blocks, all but the last must be whole
+ * @param   len    The number of bytes in `data`
+ * @return         Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__)))
+int libkeccak_parallelhash_hash_blocks(struct libkeccak_parallelhash_state *restrict, const unsigned char *restrict, size_t);
+
+/**
+ * Squeeze the chaining value of the block in the
+ * `.leaf` of a ParallelHash hashing state and
+ * absorb it into the final node
+ * 
+ * @param   state  The hashing state
+ * @return         Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__visibility__("hidden"), __nonnull__)))
+int libkeccak_parallelhash_finish_block(struct libkeccak_parallelhash_state *);
+
+
 /**
  * The outer pad pattern for HMAC
  */
@@ -98,6 +976,19 @@
  */
 #define HMAC_INNER_PAD 0x36
 
+/**
+ * Continue hashing in the sponge of an HMAC
+ * hashing state from one of its precomputed
+ * sponges, only the buffered part of the
+ * message buffer is copied
+ * 
+ * @param  STATE:struct libkeccak_hmac_state *  The HMAC hashing state
+ * @param  WHICH:identifier                     `inner` or `outer`
+ */
+#define HMAC_LOAD_SPONGE(STATE, WHICH)\
+	(libkeccak_state_copy_buffered(&(STATE)->sponge, &(STATE)->WHICH),\
+	 (STATE)->leftover = (STATE)->WHICH##_leftover)
+
 
 #ifdef NEED_EXPLICIT_BZERO
 static void *(*volatile my_explicit_memset)(void *, int, size_t) = memset;
@@ -116,3 +1007,183 @@ my_explicit_bzero(void *ptr, size_t size)
 #  pragma clang diagnostic pop
 # endif
 #endif
+
+
+#ifdef NEED_SHIFT_MESSAGE
+/**
+ * Read 8 bytes as a little-endian 64-bit word,
+ * the word does not need to be aligned
+ * 
+ * @param   msg  The location of the word
+ * @return       The word
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __warn_unused_result__)))
+static inline uint64_t
+shift_load64(const unsigned char *msg)
+{
+# if defined(HOST_LITTLE_ENDIAN)
+	uint64_t rc;
+	__builtin_memcpy(&rc, msg, sizeof(rc));
+	return rc;
+# elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	uint64_t rc;
+	__builtin_memcpy(&rc, msg, sizeof(rc));
+	return __builtin_bswap64(rc);
+# else
+	uint64_t rc = 0;
+#  define X(N) rc |= (uint64_t)msg[N] << (N * 8)
+	LIST_8(X, ;);
+#  undef X
+	return rc;
+# endif
+}
+
+
+/**
+ * Write a 64-bit word as 8 bytes in little endian,
+ * the word does not need to be aligned
+ * 
+ * @param  out    The location of the word
+ * @param  value  The word
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static inline void
+shift_store64(unsigned char *out, uint64_t value)
+{
+# if defined(HOST_LITTLE_ENDIAN)
+	__builtin_memcpy(out, &value, sizeof(value));
+# elif defined(HOST_BIG_ENDIAN) && defined(__GNUC__)
+	value = __builtin_bswap64(value);
+	__builtin_memcpy(out, &value, sizeof(value));
+# else
+#  define X(N) out[N] = (unsigned char)(value >> (N * 8))
+	LIST_8(X, ;);
+#  undef X
+# endif
+}
+
+
+/**
+ * Shift a message `n` bits towards its end, as done for
+ * HMAC when the key is not a whole number of bytes
+ * 
+ * The message is processed as 64-bit words, each output
+ * word only depends on the input, not on the previous output
+ * word, so the compiler may vectorise the loop
+ * 
+ * @param   out       Output buffer, must have room for `len` bytes
+ * @param   msg       The message, must be at least 1 byte long
+ * @param   len       The length of the message, in bytes
+ * @param   leftover  The bits to insert at the beginning of the
+ *                    message, in the lower `n` bits
+ * @param   n         The number of bits to shift, in [1, 7]
+ * @return            The bits shifted out of the message, in the lower `n` bits
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static unsigned char
+shift_message(unsigned char *restrict out, const unsigned char *restrict msg, size_t len, unsigned char leftover, int n)
+{
+	int cn = 8 - n;
+	size_t i;
+
+	leftover &= (unsigned char)((1 << n) - 1);
+	if (len >= 8) {
+		shift_store64(out, (shift_load64(msg) << n) | leftover);
+		for (i = 8; i + 8 <= len; i += 8)
+			shift_store64(&out[i], (shift_load64(&msg[i]) << n) | (uint64_t)(msg[i - 1] >> cn));
+	} else {
+		out[0] = (unsigned char)(leftover | (msg[0] << n));
+		i = 1;
+	}
+	for (; i < len; i++)
+		out[i] = (unsigned char)((msg[i - 1] >> cn) | (msg[i] << n));
+
+	return (unsigned char)(msg[len - 1] >> cn);
+}
+#endif
+
+
+#ifdef NEED_SPONGE_TRANSPOSE
+/**
+ * Copy the lanes of a sponge, transposing them
+ * 
+ * The sponge is stored with lane (x, y) at index x + 5y, but
+ * marshalled states store lane (x, y) at index 5x + y; this
+ * function converts between the two orders (the conversion
+ * is its own inverse)
+ * 
+ * The part of `dest` that is not used by lanes of the
+ * word size is cleared, so that all of it is written
+ * 
+ * @param  dest  The output buffer, must not overlap with `src`,
+ *               must have room for `sizeof(struct libkeccak_state.S)`
+ * @param  src   The sponge to transpose
+ * @param  w     The word size of the sponge
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static void
+libkeccak_transpose_sponge(void *restrict dest, const void *restrict src, long int w)
+{
+	unsigned char *restrict d = dest;
+	const unsigned char *restrict s = src;
+	size_t size = w == 8 ? sizeof(uint_fast8_t) : (size_t)w / 8;
+# define X(N) __builtin_memcpy(&d[((N % 5) * 5 + N / 5) * size], &s[N * size], size)
+	LIST_25(X, ;);
+# undef X
+	__builtin_memset(&d[25 * size], 0, sizeof(((struct libkeccak_state *)0)->S) - 25 * size);
+}
+#endif
+
+
+#ifdef NEED_LEFT_ENCODE
+/**
+ * Encode an integer as NIST SP 800-185's `left_encode`,
+ * the number of bytes of the integer followed by the bytes
+ * in big-endian order without leading zeroes (at least one)
+ * 
+ * @param   buf    Output buffer, must have room for `sizeof(uintmax_t) + 1` bytes
+ * @param   value  The integer to encode
+ * @return         The number of bytes written to `buf`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static size_t
+left_encode(unsigned char *buf, uintmax_t value)
+{
+	size_t n = 1, i;
+	uintmax_t x;
+
+	for (x = value >> 8; x; x >>= 8)
+		n += 1;
+	buf[0] = (unsigned char)n;
+	for (i = n; i; value >>= 8)
+		buf[i--] = (unsigned char)value;
+	return n + 1;
+}
+#endif
+
+
+#ifdef NEED_RIGHT_ENCODE
+/**
+ * Encode an integer as NIST SP 800-185's `right_encode`,
+ * the bytes of the integer in big-endian order without
+ * leading zeroes (at least one) followed by their number
+ * 
+ * @param   buf    Output buffer, must have room for `sizeof(uintmax_t) + 1` bytes
+ * @param   value  The integer to encode
+ * @return         The number of bytes written to `buf`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static size_t
+right_encode(unsigned char *buf, uintmax_t value)
+{
+	size_t n = 1, i;
+	uintmax_t x;
+
+	for (x = value >> 8; x; x >>= 8)
+		n += 1;
+	buf[n] = (unsigned char)n;
+	for (i = n; i--; value >>= 8)
+		buf[i] = (unsigned char)value;
+	return n + 1;
+}
+#endif
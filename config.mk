@@ -5,10 +5,26 @@ CC = c99
 
 CPPFLAGS = -D_DEFAULT_SOURCE -D_BSD_SOURCE -D_XOPEN_SOURCE=700
 CFLAGS   = -O3
-LDFLAGS  =
+LDFLAGS  = -lpthread
 
 # You can add -DALLOCA_LIMIT=# to CPPFLAGS, where # is a size_t
 # value, to put a limit on how large allocation the library is
 # allowed to make with alloca(3). For buffers that can have any
 # size this limit will be used if it wants to allocate a larger
 # buffer. Choose 0 to use malloc(3) instead of alloca(3).
+#
+# On x86, kernels for BMI1/BMI2 and AVX2 are compiled in
+# and selected at load time when the CPU supports them.
+# Add -DDISABLE_RUNTIME_DISPATCH to CPPFLAGS to only compile
+# the kernels selected by CFLAGS.
+#
+# On CPUs with 32-bit pointers, Keccak-f[1600] is performed on
+# bit-interleaved lanes, so that no 64-bit rotations are needed.
+# Add -DBIT_INTERLEAVED_1600=0 or -DBIT_INTERLEAVED_1600=1 to
+# CPPFLAGS to override this choice.
+#
+# Add -DINTERLEAVED_PAIRS=1 to CPPFLAGS to let libkeccak_digest_pair(3)
+# and libkeccak_hmac_digest_pair(3) permute the two Keccak-f[1600]
+# sponges with their instructions interleaved. This helps CPUs that
+# have many ALUs but few SIMD units, but is off by default as it is
+# slower on x86-64.
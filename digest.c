@@ -1,49 +1,222 @@
 /* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
 #include "common.h"
 
 
-#define X(N) (N % 5) * 5 + N / 5
-/**
- * The order the lanes should be read when absorbing or squeezing,
- * it transposes the lanes in the sponge
- */
-static const long int LANE_TRANSPOSE_MAP[] = { LIST_25(X, COMMA) };
-#undef X
-
-
 #include "1600.c"
 #include "800.c"
 #include "400.c"
 #include "200.c"
+#include "1600x4.c"
+#include "800x8.c"
+#include "400x16.c"
+#include "200x32.c"
 
 
 /**
- * Convert a chunk of bytes to a lane
+ * Perform the Keccak-f permutation on two sponges,
+ * one after the other
  * 
- * @param  state  The hashing state
+ * @param  state1  The first hashing state
+ * @param  state2  The second hashing state
  */
-LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __gnu_inline__)))
-static inline void
-libkeccak_f(register struct libkeccak_state *state)
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_f_pair(register struct libkeccak_state *restrict state1, register struct libkeccak_state *restrict state2)
+{
+	state1->kernels->f(state1);
+	state2->kernels->f(state2);
+}
+
+
+/**
+ * Absorb whole blocks into two sponges, one after the other
+ * 
+ * @param  state1    The first hashing state
+ * @param  message1  The blocks to absorb into `state1`
+ * @param  state2    The second hashing state
+ * @param  message2  The blocks to absorb into `state2`
+ * @param  n         The number of blocks to absorb into each state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_absorb_pair(register struct libkeccak_state *restrict state1, register const unsigned char *restrict message1,
+                      register struct libkeccak_state *restrict state2, register const unsigned char *restrict message2,
+                      register size_t n)
+{
+	state1->kernels->absorb(state1, message1, n);
+	state2->kernels->absorb(state2, message2, n);
+}
+
+
+/**
+ * The kernels for 64-bit words
+ */
+#if INTERLEAVED_PAIRS && !BIT_INTERLEAVED_1600
+static struct libkeccak_kernels kernels64 = {libkeccak_f64, libkeccak_absorb64, libkeccak_squeeze64,
+                                             libkeccak_f64_pair, libkeccak_absorb64_pair};
+#else
+static struct libkeccak_kernels kernels64 = {libkeccak_f64, libkeccak_absorb64, libkeccak_squeeze64,
+                                             libkeccak_f_pair, libkeccak_absorb_pair};
+#endif
+
+/**
+ * The kernels for 32-bit words
+ */
+static struct libkeccak_kernels kernels32 = {libkeccak_f32, libkeccak_absorb32, libkeccak_squeeze32, libkeccak_f_pair, libkeccak_absorb_pair};
+
+/**
+ * The kernels for 16-bit words
+ */
+#if defined(SSSE3_KERNELS16)
+static struct libkeccak_kernels kernels16 = {libkeccak_f16_ssse3, libkeccak_absorb16_ssse3, libkeccak_squeeze16, libkeccak_f_pair, libkeccak_absorb_pair};
+#else
+static struct libkeccak_kernels kernels16 = {libkeccak_f16, libkeccak_absorb16, libkeccak_squeeze16, libkeccak_f_pair, libkeccak_absorb_pair};
+#endif
+
+/**
+ * The kernels for 8-bit words
+ */
+#if defined(SSSE3_KERNELS8)
+static struct libkeccak_kernels kernels8 = {libkeccak_f8_ssse3, libkeccak_absorb8_ssse3, libkeccak_squeeze8, libkeccak_f_pair, libkeccak_absorb_pair};
+#else
+static struct libkeccak_kernels kernels8 = {libkeccak_f8, libkeccak_absorb8, libkeccak_squeeze8, libkeccak_f_pair, libkeccak_absorb_pair};
+#endif
+
+/**
+ * Keccak-f[1600] on four interleaved sponges
+ */
+static void (*f64x4)(uint64_t *restrict, long int) = libkeccak_f64x4;
+
+/**
+ * Keccak-f[800] on eight interleaved sponges
+ */
+static void (*f32x8)(uint32_t *restrict, long int) = libkeccak_f32x8;
+
+/**
+ * Keccak-f[400] on sixteen interleaved sponges
+ */
+static void (*f16x16)(uint16_t *restrict, long int) = libkeccak_f16x16;
+
+/**
+ * Keccak-f[200] on thirty-two interleaved sponges
+ */
+static void (*f8x32)(uint8_t *restrict, long int) = libkeccak_f8x32;
+
+
+/**
+ * Get the kernels for a word size
+ * 
+ * @param   w  The word size, 64, 32, 16, or 8
+ * @return     The kernels, `NULL` if `w` is invalid
+ */
+const struct libkeccak_kernels *
+libkeccak_get_kernels(long int w)
 {
-	register long int i = 0;
-	register long int nr = state->nr;
-
-	if (nr == 24) {
-		for (; i < nr; i++)
-			libkeccak_f_round64(state, rc64[i]);
-	} else if (nr == 22) {
-		for (; i < nr; i++)
-			libkeccak_f_round32(state, rc32[i]);
-	} else if (nr == 20) {
-		for (; i < nr; i++)
-			libkeccak_f_round16(state, rc16[i]);
-	} else if (nr == 18) {
-		libkeccak_f8(state);
+	switch (w) {
+	case 64: return &kernels64;
+	case 32: return &kernels32;
+	case 16: return &kernels16;
+	case 8:  return &kernels8;
+	default: return NULL;
 	}
 }
 
 
+#if defined(HAVE_X86_DISPATCH)
+
+/**
+ * Check whether a CPU feature is listed in the
+ * value of the environment variable LIBKECCAK_CPU_FEATURES
+ * 
+ * @param   list     The value of LIBKECCAK_CPU_FEATURES, a comma-separated list
+ * @param   feature  The name of the feature
+ * @return           1 if the feature is listed, 0 otherwise
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __pure__, __warn_unused_result__)))
+static int
+libkeccak_cpu_feature_listed(register const char *list, const char *feature)
+{
+	register size_t n = strlen(feature);
+
+	for (;;) {
+		if (!strncmp(list, feature, n) && (!list[n] || list[n] == ','))
+			return 1;
+		list = strchr(list, ',');
+		if (!list)
+			return 0;
+		list++;
+	}
+}
+
+
+/**
+ * Select the kernels to use on the running CPU
+ * 
+ * Runs when the library is loaded; until then the kernels
+ * selected at compile time are used, they are only slower.
+ * States point to the kernel tables rather than copying
+ * them, so states created before this also use the
+ * selected kernels
+ * 
+ * If the environment variable LIBKECCAK_CPU_FEATURES is set,
+ * only the CPU features it lists ("bmi" for BMI1 and BMI2,
+ * "ssse3" for SSSE3, "avx2" for AVX2) are used, this is intended for testing
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__constructor__)))
+static void
+libkeccak_select_kernels(void)
+{
+	const char *allowed = getenv("LIBKECCAK_CPU_FEATURES");
+	int bmi, ssse3, avx2;
+
+	__builtin_cpu_init();
+	bmi = __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+	ssse3 = __builtin_cpu_supports("ssse3");
+	avx2 = __builtin_cpu_supports("avx2");
+	if (allowed) {
+		bmi = bmi && libkeccak_cpu_feature_listed(allowed, "bmi");
+		ssse3 = ssse3 && libkeccak_cpu_feature_listed(allowed, "ssse3");
+		avx2 = avx2 && libkeccak_cpu_feature_listed(allowed, "avx2");
+	}
+
+	if (bmi) {
+		kernels64.f = libkeccak_f64_bmi;
+		kernels32.f = libkeccak_f32_bmi;
+		kernels16.f = libkeccak_f16_bmi;
+		kernels64.absorb = libkeccak_absorb64_bmi;
+		kernels32.absorb = libkeccak_absorb32_bmi;
+		kernels16.absorb = libkeccak_absorb16_bmi;
+# if INTERLEAVED_PAIRS && !BIT_INTERLEAVED_1600
+		kernels64.f_pair = libkeccak_f64_pair_bmi;
+		kernels64.absorb_pair = libkeccak_absorb64_pair_bmi;
+# endif
+	}
+
+	/* For 16-bit words, the scalar BMI kernel is slightly faster */
+	if (ssse3 && !bmi) {
+		kernels16.f = libkeccak_f16_ssse3;
+		kernels16.absorb = libkeccak_absorb16_ssse3;
+	}
+
+	if (ssse3) {
+# if UINT_FAST8_MAX == UINT8_MAX
+		kernels8.f = libkeccak_f8_ssse3;
+		kernels8.absorb = libkeccak_absorb8_ssse3;
+# endif
+	}
+
+	if (avx2) {
+		f64x4 = libkeccak_f64x4_avx2;
+		f32x8 = libkeccak_f32x8_avx2;
+		f16x16 = libkeccak_f16x16_avx2;
+		f8x32 = libkeccak_f8x32_avx2;
+	}
+}
+
+#endif
+
+
 /**
  * Right-pad message with a 10*1-pad
  * 
@@ -92,47 +265,181 @@ static void
 libkeccak_absorption_phase(register struct libkeccak_state *restrict state,
                            register const unsigned char *restrict message, register size_t len)
 {
-	register long int rr = state->r >> 3;
-	register long int ww = state->w >> 3;
-	register long int n = (long)len / rr;
-
-	if (__builtin_expect(ww == 8, 1)) {
-		while (n--) {
-#define X(N) state->S.w64[N] ^= libkeccak_to_lane64(message, len, rr, (size_t)(LANE_TRANSPOSE_MAP[N] * 8))
-			LIST_25(X, ;);
-#undef X
-			libkeccak_f(state);
-			message += (size_t)rr;
-			len -= (size_t)rr;
-		}
-	} else if (__builtin_expect(ww == 4, 1)) {
-		while (n--) {
-#define X(N) state->S.w32[N] ^= libkeccak_to_lane32(message, len, rr, (size_t)(LANE_TRANSPOSE_MAP[N] * 4))
-			LIST_25(X, ;);
-#undef X
-			libkeccak_f(state);
-			message += (size_t)rr;
-			len -= (size_t)rr;
-		}
-	} else if (__builtin_expect(ww == 2, 1)) {
-		while (n--) {
-#define X(N) state->S.w16[N] ^= libkeccak_to_lane16(message, len, rr, (size_t)(LANE_TRANSPOSE_MAP[N] * 2))
-			LIST_25(X, ;);
-#undef X
-			libkeccak_f(state);
-			message += (size_t)rr;
-			len -= (size_t)rr;
-		}
-	} else if (__builtin_expect(ww == 1, 1)) {
-		while (n--) {
-#define X(N) state->S.w8[N] ^= libkeccak_to_lane8(message, len, rr, (size_t)(LANE_TRANSPOSE_MAP[N] * 1))
-			LIST_25(X, ;);
-#undef X
-			libkeccak_f(state);
-			message += (size_t)rr;
-			len -= (size_t)rr;
+	state->kernels->absorb(state, message, len / (size_t)(state->r >> 3));
+}
+
+
+/**
+ * Copy the last part of a message to a buffer, and
+ * append the suffix and a 10*1-pad to it
+ * 
+ * @param   r           Should be `state->r` where `state` is the hashing state
+ * @param   buf         Output buffer, must have room for `msglen` bytes, the
+ *                      suffix, and the pad, which may extend into another block
+ * @param   msg         The rest of the message, may be `NULL` if `msglen` and `bits` are 0
+ * @param   msglen      The number of whole bytes in `msg`, should be less than `r / 8`
+ * @param   bits        The number of bits at the end of `msg` that does not make a whole byte
+ * @param   suffix      The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
+ * @param   suffix_len  The number of bits in `suffix`
+ * @return              The length of the padded message, a multiple of `r / 8`
+ */
+size_t
+libkeccak_pad_final(size_t r, unsigned char *restrict buf, const unsigned char *restrict msg, size_t msglen,
+                    size_t bits, const char *restrict suffix, size_t suffix_len)
+{
+	if (msglen)
+		__builtin_memcpy(buf, msg, msglen * sizeof(char));
+
+	if (bits)
+		buf[msglen] = msg[msglen] & (unsigned char)((1 << bits) - 1);
+	if (__builtin_expect(!!suffix_len, 1)) {
+		if (!bits)
+			buf[msglen] = 0;
+		while (suffix_len--) {
+			buf[msglen] |= (unsigned char)((*suffix++ & 1) << bits++);
+			if (bits == 8) {
+				bits = 0;
+				buf[++msglen] = 0;
+			}
 		}
 	}
+	if (bits)
+		msglen++;
+
+	return libkeccak_pad10star1(r, buf, msglen, bits);
+}
+
+
+/**
+ * Define the functions for a `struct libkeccak_multi`
+ * 
+ * @param  W     The word size
+ * @param  WAYS  The number of sponges
+ * @param  T     The type of the lanes in `struct libkeccak_state`
+ */
+#define LIBKECCAK_MULTI(W, WAYS, T)\
+	LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))\
+	static void\
+	libkeccak_absorption_phase_##W##x##WAYS(register union libkeccak_multi_sponge *restrict S,\
+	                                        const unsigned char *const *restrict messages, register long int rr,\
+	                                        long int nr)\
+	{\
+		register long int i, k, n = rr / (W / 8);\
+		for (k = 0; k < WAYS; k++) {\
+			for (i = 0; i < n; i++)\
+				S->w##W[i * WAYS + k] ^= libkeccak_load##W(&messages[k][i * (W / 8)]);\
+			if (rr % (W / 8))\
+				S->w##W[n * WAYS + k] ^= libkeccak_to_lane##W(messages[k], (size_t)rr, rr, (size_t)(n * (W / 8)));\
+		}\
+		f##W##x##WAYS(S->w##W, nr);\
+	}\
+	\
+	LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))\
+	static void\
+	libkeccak_squeezing_phase_##W##x##WAYS(register union libkeccak_multi_sponge *restrict S, long int r, long int n,\
+	                                       long int nr, unsigned char *const *restrict hashsums)\
+	{\
+		register long int rr = r >> 3;\
+		register long int nn = (n + 7) >> 3;\
+		auto T lanes[25];\
+		auto unsigned char *out[WAYS];\
+		auto long int olen = n;\
+		register long int i, k, len;\
+		\
+		for (k = 0; k < WAYS; k++)\
+			out[k] = hashsums[k];\
+		\
+		while (olen > 0) {\
+			len = nn < rr ? nn : rr;\
+			for (k = 0; k < WAYS; k++) {\
+				if (!out[k])\
+					continue;\
+				for (i = 0; i <= len / (W / 8) && i < 25; i++)\
+					lanes[i] = S->w##W[i * WAYS + k];\
+				libkeccak_squeeze_block##W(lanes, out[k], len);\
+				out[k] += len;\
+			}\
+			nn -= len;\
+			olen -= r;\
+			if (olen > 0)\
+				f##W##x##WAYS(S->w##W, nr);\
+		}\
+		\
+		if (n & 7)\
+			for (k = 0; k < WAYS; k++)\
+				if (out[k])\
+					out[k][-1] &= (unsigned char)((1 << (n & 7)) - 1);\
+	}\
+	\
+	LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))\
+	static void\
+	libkeccak_multi_extract_##W##x##WAYS(register struct libkeccak_state *restrict state,\
+	                                     register const union libkeccak_multi_sponge *restrict S, register long int k)\
+	{\
+		register long int i;\
+		for (i = 0; i < 25; i++)\
+			state->S.w##W[i] = S->w##W[i * WAYS + k];\
+	}\
+	\
+	LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))\
+	static void\
+	libkeccak_multi_clear_##W##x##WAYS(register union libkeccak_multi_sponge *restrict S, register long int k)\
+	{\
+		register long int i;\
+		for (i = 0; i < 25; i++)\
+			S->w##W[i * WAYS + k] = 0;\
+	}\
+	\
+	LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))\
+	static void\
+	libkeccak_multi_insert_##W##x##WAYS(register union libkeccak_multi_sponge *restrict S,\
+	                                    register const struct libkeccak_state *restrict state, register long int k)\
+	{\
+		register long int i;\
+		for (i = 0; i < 25; i++)\
+			S->w##W[i * WAYS + k] = (uint##W##_t)state->S.w##W[i];\
+	}\
+	\
+	LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))\
+	static void\
+	libkeccak_multi_permute_##W##x##WAYS(register union libkeccak_multi_sponge *restrict S, register long int nr)\
+	{\
+		f##W##x##WAYS(S->w##W, nr);\
+	}\
+	\
+	static const struct libkeccak_multi multi##W = {\
+		WAYS,\
+		libkeccak_absorption_phase_##W##x##WAYS,\
+		libkeccak_squeezing_phase_##W##x##WAYS,\
+		libkeccak_multi_extract_##W##x##WAYS,\
+		libkeccak_multi_clear_##W##x##WAYS,\
+		libkeccak_multi_insert_##W##x##WAYS,\
+		libkeccak_multi_permute_##W##x##WAYS\
+	}
+
+LIBKECCAK_MULTI(64, 4, uint64_t);
+LIBKECCAK_MULTI(32, 8, uint32_t);
+LIBKECCAK_MULTI(16, 16, uint16_t);
+LIBKECCAK_MULTI(8, 32, uint_fast8_t);
+
+
+/**
+ * Get the functions for processing interleaved sponges
+ * 
+ * @param   w  The word size
+ * @return     The functions, `NULL` if there are no
+ *             multi-buffer kernels for the word size
+ */
+const struct libkeccak_multi *
+libkeccak_get_multi(long int w)
+{
+	switch (w) {
+	case 64: return &multi64;
+	case 32: return &multi32;
+	case 16: return &multi16;
+	case 8:  return &multi8;
+	default: return NULL;
+	}
 }
 
 
@@ -142,202 +449,216 @@ libkeccak_absorption_phase(register struct libkeccak_state *restrict state,
  * @param  state    The hashing state
  * @param  rr       The bitrate in bytes
  * @param  nn       The output size in bytes, rounded up to whole bytes
- * @param  ww       The word size in bytes
  * @param  hashsum  Output parameter for the hashsum
  */
-LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
-static void
+void
 libkeccak_squeezing_phase(register struct libkeccak_state *restrict state, long int rr,
-                          long int nn, long int ww, register unsigned char *restrict hashsum)
+                          long int nn, register unsigned char *restrict hashsum)
 {
-	register long int ni = (rr - 1) / ww + 1;
 	auto long int olen = state->n;
-	auto long int i, j = 0;
-	register long int k;
-	if (__builtin_expect(ww == 8, 1)) {
-		register uint64_t v;
-		while (olen > 0) {
-			for (i = 0; i < ni && j < nn; i++) {
-				v = state->S.w64[LANE_TRANSPOSE_MAP[i]];
-				for (k = 0; k++ < ww && j++ < nn; v >>= 8)
-					*hashsum++ = (unsigned char)v;
-			}
-			olen -= state->r;
-			if (olen > 0)
-				libkeccak_f(state);
-		}
-		if (state->n & 7)
-			hashsum[-1] &= (unsigned char)((1 << (state->n & 7)) - 1);
-	} else if (__builtin_expect(ww == 4, 1)) {
-		register uint32_t v;
-		while (olen > 0) {
-			for (i = 0; i < ni && j < nn; i++) {
-				v = state->S.w32[LANE_TRANSPOSE_MAP[i]];
-				for (k = 0; k++ < ww && j++ < nn; v >>= 8)
-					*hashsum++ = (unsigned char)v;
-			}
-			olen -= state->r;
-			if (olen > 0)
-				libkeccak_f(state);
-		}
-		if (state->n & 7)
-			hashsum[-1] &= (unsigned char)((1 << (state->n & 7)) - 1);
-	} else if (__builtin_expect(ww == 2, 1)) {
-		register uint16_t v;
-		while (olen > 0) {
-			for (i = 0; i < ni && j < nn; i++) {
-				v = state->S.w16[LANE_TRANSPOSE_MAP[i]];
-				for (k = 0; k++ < ww && j++ < nn; v >>= 8)
-					*hashsum++ = (unsigned char)v;
-			}
-			olen -= state->r;
-			if (olen > 0)
-				libkeccak_f(state);
-		}
-		if (state->n & 7)
-			hashsum[-1] &= (unsigned char)((1 << (state->n & 7)) - 1);
-	} else if (__builtin_expect(ww == 1, 1)) {
-		register uint8_t v;
-		while (olen > 0) {
-			for (i = 0; i < ni && j < nn; i++, j++) {
-				v = state->S.w8[LANE_TRANSPOSE_MAP[i]];
-				*hashsum++ = (unsigned char)v;
-			}
-			olen -= state->r;
-			if (olen > 0)
-				libkeccak_f(state);
-		}
-		if (state->n & 7)
-			hashsum[-1] &= (unsigned char)((1 << (state->n & 7)) - 1);
+	register long int len;
+
+	while (olen > 0) {
+		len = nn < rr ? nn : rr;
+		state->kernels->squeeze(state, hashsum, len);
+		hashsum += len;
+		nn -= len;
+		olen -= state->r;
+		if (olen > 0)
+			state->kernels->f(state);
 	}
+	if (state->n & 7)
+		hashsum[-1] &= (unsigned char)((1 << (state->n & 7)) - 1);
 }
 
 
 /**
  * Absorb more of the message to the Keccak sponge
- * without copying the data to an internal buffer
  * 
- * It is safe to run zero-copy functions before non-zero-copy
- * functions for the same state, running zero-copy functions
- * after non-zero-copy functions on the other hand can
- * cause the message to be misread
+ * Whole blocks are absorbed directly from `msg`, only a
+ * partial block is copied into the state's buffer
+ * 
+ * @param  state   The hashing state
+ * @param  msg     The partial message
+ * @param  msglen  The length of the partial message
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1), __nothrow__)))
+static void
+libkeccak_buffered_update(register struct libkeccak_state *restrict state,
+                          register const unsigned char *restrict msg, register size_t msglen)
+{
+	register size_t rr = (size_t)(state->r >> 3);
+	register size_t len;
+
+	if (!msglen)
+		return;
+
+	if (state->mptr) {
+		len = rr - state->mptr;
+		if (len > msglen)
+			len = msglen;
+		__builtin_memcpy(&state->M[state->mptr], msg, len * sizeof(char));
+		state->mptr += len;
+		if (state->mptr < rr)
+			return;
+		libkeccak_absorption_phase(state, state->M, rr);
+		state->mptr = 0;
+		msg += len;
+		msglen -= len;
+	}
+
+	len = msglen - msglen % rr;
+	if (len) {
+		libkeccak_absorption_phase(state, msg, len);
+		msg += len;
+		msglen -= len;
+	}
+
+	if (msglen) {
+		__builtin_memcpy(state->M, msg, msglen * sizeof(char));
+		state->mptr = msglen;
+	}
+}
+
+
+/**
+ * Absorb more of the message to the Keccak sponge
+ * without copying whole blocks to an internal buffer
+ * 
+ * This is equivalent to `libkeccak_fast_update`, which
+ * also absorbs whole blocks directly from `msg`
  * 
  * @param  state   The hashing state
  * @param  msg     The partial message
- * @param  msglen  The length of the partial message; must be a
- *                 multiple of `libkeccak_zerocopy_chunksize(state)`
- *                 (undefined behaviour otherwise)
+ * @param  msglen  The length of the partial message
  */
 void
 libkeccak_zerocopy_update(struct libkeccak_state *restrict state, const void *restrict msg, size_t msglen)
 {
-	libkeccak_absorption_phase(state, msg, msglen);
+	libkeccak_buffered_update(state, msg, msglen);
 }
 
 
 /**
  * Absorb more of the message to the Keccak sponge
- * without wiping sensitive data when possible
+ * 
+ * Whole blocks are absorbed directly from `msg`, and
+ * less than one block is kept in `state->M`, so no
+ * memory is allocated and nothing needs to be wiped
  * 
  * @param   state   The hashing state
  * @param   msg     The partial message
  * @param   msglen  The length of the partial message
- * @return          Zero on success, -1 on error
+ * @return          Zero
  */
 int
 libkeccak_fast_update(struct libkeccak_state *restrict state, const void *restrict msg, size_t msglen)
 {
-	size_t len;
-	auto unsigned char *restrict new;
-
-	if (__builtin_expect(state->mptr + msglen > state->mlen, 0)) {
-		state->mlen += msglen;
-		new = realloc(state->M, state->mlen * sizeof(char));
-		if (!new) {
-			state->mlen -= msglen;
-			return -1;
-		}
-		state->M = new;
-	}
-
-	__builtin_memcpy(state->M + state->mptr, msg, msglen * sizeof(char));
-	state->mptr += msglen;
-	len = state->mptr;
-	len -= state->mptr % (size_t)(state->r >> 3);
-	state->mptr -= len;
-
-	libkeccak_absorption_phase(state, state->M, len);
-	__builtin_memmove(state->M, state->M + len, state->mptr * sizeof(char));
-
+	libkeccak_buffered_update(state, msg, msglen);
 	return 0;
 }
 
 
 /**
  * Absorb more of the message to the Keccak sponge
- * and wipe sensitive data when possible
+ * 
+ * Whole blocks are absorbed directly from `msg`, and
+ * less than one block is kept in `state->M`, so no
+ * memory is allocated and nothing needs to be wiped
  * 
  * @param   state   The hashing state
  * @param   msg     The partial message
  * @param   msglen  The length of the partial message
- * @return          Zero on success, -1 on error
+ * @return          Zero
  */
 int
 libkeccak_update(struct libkeccak_state *restrict state, const void *restrict msg, size_t msglen)
 {
-	size_t len;
-	auto unsigned char *restrict new;
-
-	if (__builtin_expect(state->mptr + msglen > state->mlen, 0)) {
-		state->mlen += msglen;
-		new = malloc(state->mlen * sizeof(char));
-		if (!new) {
-			state->mlen -= msglen;
-			return -1;
+	libkeccak_buffered_update(state, msg, msglen);
+	return 0;
+}
+
+
+/**
+ * Append the suffix and the 10*1-pad to the message
+ * buffered in the state, so that `state->M` holds the
+ * last block, which is not absorbed
+ * 
+ * @param  state       The hashing state, `state->M` must have
+ *                     `state->mptr` whole bytes and `bits` bits
+ *                     of the message buffered
+ * @param  bits        The number of bits at the end of the message that does not make a whole byte
+ * @param  suffix      The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
+ * @param  suffix_len  The number of bits in `suffix`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1), __nothrow__)))
+static void
+libkeccak_pad_buffered(register struct libkeccak_state *restrict state, register size_t bits,
+                       const char *restrict suffix, size_t suffix_len)
+{
+	register size_t rr = (size_t)(state->r >> 3);
+	register unsigned char b = (unsigned char)(bits ? state->M[state->mptr] & ((1 << bits) - 1) : 0);
+
+	while (suffix_len--) {
+		b |= (unsigned char)((*suffix++ & 1) << bits++);
+		if (bits == 8) {
+			state->M[state->mptr++] = b;
+			if (state->mptr == rr) {
+				libkeccak_absorption_phase(state, state->M, rr);
+				state->mptr = 0;
+			}
+			b = 0;
+			bits = 0;
 		}
-		libkeccak_state_wipe_message(state);
-		free(state->M);
-		state->M = new;
 	}
 
-	__builtin_memcpy(state->M + state->mptr, msg, msglen * sizeof(char));
-	state->mptr += msglen;
-	len = state->mptr;
-	len -= state->mptr % (size_t)(state->r >> 3);
-	state->mptr -= len;
+	state->M[state->mptr++] = (unsigned char)(b | (1 << bits));
+	if (bits == 7 && state->mptr == rr) {
+		libkeccak_absorption_phase(state, state->M, rr);
+		state->mptr = 0;
+	}
+	__builtin_memset(&state->M[state->mptr], 0, (rr - state->mptr) * sizeof(char));
+	state->M[rr - 1] |= 0x80;
+}
 
-	libkeccak_absorption_phase(state, state->M, len);
-	__builtin_memmove(state->M, state->M + len, state->mptr * sizeof(char));
 
-	return 0;
+/**
+ * Append the suffix and the 10*1-pad to the message
+ * buffered in the state, and absorb it
+ * 
+ * @param  state       The hashing state, `state->M` must have
+ *                     `state->mptr` whole bytes and `bits` bits
+ *                     of the message buffered
+ * @param  bits        The number of bits at the end of the message that does not make a whole byte
+ * @param  suffix      The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
+ * @param  suffix_len  The number of bits in `suffix`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1), __nothrow__)))
+static void
+libkeccak_absorb_final(register struct libkeccak_state *restrict state, register size_t bits,
+                       const char *restrict suffix, size_t suffix_len)
+{
+	libkeccak_pad_buffered(state, bits, suffix, suffix_len);
+	libkeccak_absorption_phase(state, state->M, (size_t)(state->r >> 3));
+	state->mptr = 0;
 }
 
 
 /**
  * Absorb the last part of the message and squeeze the Keccak sponge
- * without copying the data to an internal buffer
- * 
- * It is safe to run zero-copy functions before non-zero-copy
- * functions for the same state, running zero-copy functions
- * after non-zero-copy functions on the other hand can
- * cause the message to be misread
  * 
  * @param  state    The hashing state
- * @param  msg_     The rest of the message; will be edited; extra memory
- *                  shall be allocated such that `suffix` and a 10*1 pad (which
- *                  is at least 2 bits long) can be added in a way that makes its
- *                  length a multiple of `libkeccak_zerocopy_chunksize(state)`
+ * @param  msg      The rest of the message, may be `NULL`
  * @param  msglen   The length of the partial message
  * @param  bits     The number of bits at the end of the message not covered by `msglen`
  * @param  suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
  * @param  hashsum  Output parameter for the hashsum, may be `NULL`
  */
-void
-libkeccak_zerocopy_digest(struct libkeccak_state *restrict state, void *restrict msg_, size_t msglen,
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1), __nothrow__)))
+static void
+libkeccak_buffered_digest(struct libkeccak_state *restrict state, const unsigned char *restrict msg, size_t msglen,
                           size_t bits, const char *restrict suffix, void *restrict hashsum)
 {
-	unsigned char *restrict msg = msg_;
-	register long int rr = state->r >> 3;
 	auto size_t suffix_len = suffix ? __builtin_strlen(suffix) : 0;
 	register long int i;
 
@@ -349,34 +670,42 @@ libkeccak_zerocopy_digest(struct libkeccak_state *restrict state, void *restrict
 		bits &= 7;
 	}
 
+	libkeccak_buffered_update(state, msg, msglen);
 	if (bits)
-		msg[msglen] = msg[msglen] & (unsigned char)((1 << bits) - 1);
-	if (__builtin_expect(!!suffix_len, 1)) {
-		if (!bits)
-			msg[msglen] = 0;
-		while (suffix_len--) {
-			msg[msglen] |= (unsigned char)((*suffix++ & 1) << bits++);
-			if (bits == 8) {
-				bits = 0;
-				msg[++msglen] = 0;
-			}
-		}
-	}
-	if (bits)
-		msglen++;
-
-	msglen = libkeccak_pad10star1((size_t)state->r, msg, msglen, bits);
-	libkeccak_absorption_phase(state, msg, msglen);
+		state->M[state->mptr] = msg[msglen];
+	libkeccak_absorb_final(state, bits, suffix, suffix_len);
 
 	if (hashsum) {
-		libkeccak_squeezing_phase(state, rr, (state->n + 7) >> 3, state->w >> 3, hashsum);
+		libkeccak_squeezing_phase(state, state->r >> 3, (state->n + 7) >> 3, hashsum);
 	} else {
 		for (i = (state->n - 1) / state->r; i--;)
-			libkeccak_f(state);
+			state->kernels->f(state);
 	}
 }
 
 
+/**
+ * Absorb the last part of the message and squeeze the Keccak sponge
+ * without copying the data to an internal buffer
+ * 
+ * This is equivalent to `libkeccak_fast_digest`, which also
+ * absorbs whole blocks directly from `msg`; `msg` is not modified
+ * 
+ * @param  state    The hashing state
+ * @param  msg_     The rest of the message, may be `NULL`
+ * @param  msglen   The length of the partial message
+ * @param  bits     The number of bits at the end of the message not covered by `msglen`
+ * @param  suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
+ * @param  hashsum  Output parameter for the hashsum, may be `NULL`
+ */
+void
+libkeccak_zerocopy_digest(struct libkeccak_state *restrict state, void *restrict msg_, size_t msglen,
+                          size_t bits, const char *restrict suffix, void *restrict hashsum)
+{
+	libkeccak_buffered_digest(state, msg_, msglen, bits, suffix, hashsum);
+}
+
+
 /**
  * Absorb the last part of the message and squeeze the Keccak sponge
  * without wiping sensitive data when possible
@@ -387,75 +716,20 @@ libkeccak_zerocopy_digest(struct libkeccak_state *restrict state, void *restrict
  * @param   bits     The number of bits at the end of the message not covered by `msglen`
  * @param   suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
  * @param   hashsum  Output parameter for the hashsum, may be `NULL`
- * @return           Zero on success, -1 on error
+ * @return           Zero
  */
 int
 libkeccak_fast_digest(struct libkeccak_state *restrict state, const void *restrict msg_, size_t msglen,
                       size_t bits, const char *restrict suffix, void *restrict hashsum)
 {
-	const unsigned char *restrict msg = msg_;
-	auto unsigned char *restrict new;
-	register long int rr = state->r >> 3;
-	auto size_t suffix_len = suffix ? __builtin_strlen(suffix) : 0;
-	register size_t ext;
-	register long int i;
-
-	if (!msg) {
-		msglen = 0;
-		bits = 0;
-	} else {
-		msglen += bits >> 3;
-		bits &= 7;
-	}
-
-	ext = msglen + ((bits + suffix_len + 7) >> 3) + (size_t)rr;
-	if (__builtin_expect(state->mptr + ext > state->mlen, 0)) {
-		state->mlen += ext;
-		new = realloc(state->M, state->mlen * sizeof(char));
-		if (!new) {
-			state->mlen -= ext;
-			return -1;
-		}
-		state->M = new;
-	}
-
-	if (msglen)
-		__builtin_memcpy(state->M + state->mptr, msg, msglen * sizeof(char));
-	state->mptr += msglen;
-
-	if (bits)
-		state->M[state->mptr] = msg[msglen] & (unsigned char)((1 << bits) - 1);
-	if (__builtin_expect(!!suffix_len, 1)) {
-		if (!bits)
-			state->M[state->mptr] = 0;
-		while (suffix_len--) {
-			state->M[state->mptr] |= (unsigned char)((*suffix++ & 1) << bits++);
-			if (bits == 8) {
-				bits = 0;
-				state->M[++(state->mptr)] = 0;
-			}
-		}
-	}
-	if (bits)
-		state->mptr++;
-
-	state->mptr = libkeccak_pad10star1((size_t)state->r, state->M, state->mptr, bits);
-	libkeccak_absorption_phase(state, state->M, state->mptr);
-
-	if (hashsum) {
-		libkeccak_squeezing_phase(state, rr, (state->n + 7) >> 3, state->w >> 3, hashsum);
-	} else {
-		for (i = (state->n - 1) / state->r; i--;)
-			libkeccak_f(state);
-	}
-
+	libkeccak_buffered_digest(state, msg_, msglen, bits, suffix, hashsum);
 	return 0;
 }
 
 
 /**
- * Absorb the last part of the message and squeeze the Keccak sponge
- * and wipe sensitive data when possible
+ * Absorb the last part of the message and squeeze the Keccak sponge,
+ * and wipe the message buffered in the state
  * 
  * @param   state    The hashing state
  * @param   msg_     The rest of the message, may be `NULL`
@@ -463,70 +737,14 @@ libkeccak_fast_digest(struct libkeccak_state *restrict state, const void *restri
  * @param   bits     The number of bits at the end of the message not covered by `msglen`
  * @param   suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
  * @param   hashsum  Output parameter for the hashsum, may be `NULL`
- * @return           Zero on success, -1 on error
+ * @return           Zero
  */
 int
 libkeccak_digest(struct libkeccak_state *restrict state, const void *restrict msg_, size_t msglen,
                  size_t bits, const char *restrict suffix, void *restrict hashsum)
 {
-	const unsigned char *restrict msg = msg_;
-	auto unsigned char *restrict new;
-	register long int rr = state->r >> 3;
-	auto size_t suffix_len = suffix ? __builtin_strlen(suffix) : 0;
-	register size_t ext;
-	register long int i;
-
-	if (!msg) {
-		msglen = 0;
-		bits = 0;
-	} else {
-		msglen += bits >> 3;
-		bits &= 7;
-	}
-
-	ext = msglen + ((bits + suffix_len + 7) >> 3) + (size_t)rr;
-	if (__builtin_expect(state->mptr + ext > state->mlen, 0)) {
-		state->mlen += ext;
-		new = malloc(state->mlen * sizeof(char));
-		if (!new) {
-			state->mlen -= ext;
-			return -1;
-		}
-		libkeccak_state_wipe_message(state);
-		free(state->M);
-		state->M = new;
-	}
-
-	if (msglen)
-		__builtin_memcpy(state->M + state->mptr, msg, msglen * sizeof(char));
-	state->mptr += msglen;
-
-	if (bits)
-		state->M[state->mptr] = msg[msglen] & (unsigned char)((1 << bits) - 1);
-	if (__builtin_expect(!!suffix_len, 1)) {
-		if (!bits)
-			state->M[state->mptr] = 0;
-		while (suffix_len--) {
-			state->M[state->mptr] |= (unsigned char)((*suffix++ & 1) << bits++);
-			if (bits == 8) {
-				bits = 0;
-				state->M[++(state->mptr)] = 0;
-			}
-		}
-	}
-	if (bits)
-		state->mptr++;
-
-	state->mptr = libkeccak_pad10star1((size_t)state->r, state->M, state->mptr, bits);
-	libkeccak_absorption_phase(state, state->M, state->mptr);
-
-	if (hashsum) {
-		libkeccak_squeezing_phase(state, rr, (state->n + 7) >> 3, state->w >> 3, hashsum);
-	} else {
-		for (i = (state->n - 1) / state->r; i--;)
-			libkeccak_f(state);
-	}
-
+	libkeccak_buffered_digest(state, msg_, msglen, bits, suffix, hashsum);
+	libkeccak_state_wipe_message(state);
 	return 0;
 }
 
@@ -541,7 +759,7 @@ void
 libkeccak_simple_squeeze(register struct libkeccak_state *state, register long int times)
 {
 	while (times--)
-		libkeccak_f(state);
+		state->kernels->f(state);
 }
 
 
@@ -563,6 +781,349 @@ extern inline void libkeccak_fast_squeeze(register struct libkeccak_state *state
 void
 libkeccak_squeeze(register struct libkeccak_state *restrict state, register void *restrict hashsum)
 {
-	libkeccak_f(state);
-	libkeccak_squeezing_phase(state, state->r >> 3, (state->n + 7) >> 3, state->w >> 3, hashsum);
+	state->kernels->f(state);
+	libkeccak_squeezing_phase(state, state->r >> 3, (state->n + 7) >> 3, hashsum);
+}
+
+
+/**
+ * Calculate the hashsums of multiple messages
+ * 
+ * @param   state     An initialised state with the specifications
+ *                    for the hashing algorithm, will be destroyed
+ * @param   msgs      The messages, an element may be `NULL` if
+ *                    the corresponding element in `lens` is 0
+ * @param   lens      The length of each message, in bytes
+ * @param   suffix    The suffix concatenate to each message, only '1':s and '0':s, and NUL-termination
+ * @param   hashsums  Output parameters for the hashsums
+ * @param   n         The number of messages
+ * @return            Zero on success, -1 on error
+ */
+static int
+digest_many(struct libkeccak_state *restrict state, const void *const *restrict msgs,
+            const size_t *restrict lens, const char *restrict suffix, void *const *restrict hashsums, size_t n)
+{
+	union libkeccak_multi_sponge S;
+	unsigned char pad[MAX_WAYS][2 * 200];
+	const unsigned char *msg[MAX_WAYS];
+	const unsigned char *block[MAX_WAYS];
+	unsigned char *out[MAX_WAYS];
+	size_t full[MAX_WAYS], blocks[MAX_WAYS], padded, common, count, ways, i, j, k;
+	size_t suffix_len = suffix ? __builtin_strlen(suffix) : 0;
+	const struct libkeccak_multi *multi;
+	long int rr;
+
+	rr = state->r >> 3;
+
+	multi = libkeccak_get_multi(state->w);
+	if (!multi || suffix_len > (size_t)rr * 8) {
+		i = 0;
+		goto scalar;
+	}
+	ways = (size_t)multi->ways;
+
+	for (i = 0; n - i > 1; i += count) {
+		count = n - i < ways ? n - i : ways;
+		common = SIZE_MAX;
+		for (k = 0; k < ways; k++) {
+			if (k >= count) {
+				__builtin_memset(pad[k], 0, (size_t)rr * sizeof(char));
+				msg[k] = NULL;
+				full[k] = 0;
+				blocks[k] = SIZE_MAX;
+				out[k] = NULL;
+				continue;
+			}
+			msg[k] = msgs[i + k];
+			full[k] = lens[i + k] / (size_t)rr;
+			padded = libkeccak_pad_final((size_t)state->r, pad[k], msg[k] ? &msg[k][full[k] * (size_t)rr] : NULL,
+			                             lens[i + k] % (size_t)rr, 0, suffix, suffix_len);
+			blocks[k] = full[k] + padded / (size_t)rr;
+			if (blocks[k] < common)
+				common = blocks[k];
+			out[k] = hashsums[i + k];
+		}
+
+		__builtin_memset(&S, 0, sizeof(S));
+		for (j = 0; j < common; j++) {
+			for (k = 0; k < ways; k++) {
+				if (k >= count)
+					block[k] = pad[k];
+				else if (j < full[k])
+					block[k] = &msg[k][j * (size_t)rr];
+				else
+					block[k] = &pad[k][(j - full[k]) * (size_t)rr];
+			}
+			multi->absorb(&S, block, rr, state->nr);
+		}
+
+		for (k = 0; k < count && blocks[k] == common; k++);
+		if (k == count) {
+			multi->squeeze(&S, state->r, state->n, state->nr, out);
+			continue;
+		}
+
+		for (k = 0; k < count; k++) {
+			multi->extract(state, &S, (long int)k);
+			if (common < full[k])
+				libkeccak_absorption_phase(state, &msg[k][common * (size_t)rr], (full[k] - common) * (size_t)rr);
+			j = common > full[k] ? common - full[k] : 0;
+			libkeccak_absorption_phase(state, &pad[k][j * (size_t)rr], (blocks[k] - full[k] - j) * (size_t)rr);
+			libkeccak_squeezing_phase(state, rr, (state->n + 7) >> 3, out[k]);
+		}
+	}
+
+	my_explicit_bzero(&S, sizeof(S));
+	my_explicit_bzero(pad, sizeof(pad));
+
+scalar:
+	for (; i < n; i++) {
+		libkeccak_state_reset(state);
+		if (libkeccak_digest(state, msgs[i], lens[i], 0, suffix, hashsums[i]) < 0) {
+			libkeccak_state_destroy(state);
+			return -1;
+		}
+	}
+
+	libkeccak_state_destroy(state);
+	return 0;
+}
+
+
+/**
+ * Calculate the hashsums of multiple messages
+ * 
+ * Messages are processed several at a time, with their sponges
+ * permuted in parallel, when the word size is at least 8 bits:
+ * four at a time for 1600-bit states, eight for 800-bit states,
+ * sixteen for 400-bit states, and thirty-two for 200-bit states
+ * 
+ * @param   spec      The specifications for the hashing algorithm
+ * @param   msgs      The messages, an element may be `NULL` if
+ *                    the corresponding element in `lens` is 0
+ * @param   lens      The length of each message, in bytes
+ * @param   suffix    The suffix concatenate to each message, only '1':s and '0':s, and NUL-termination
+ * @param   hashsums  Output parameters for the hashsums
+ * @param   n         The number of messages
+ * @return            Zero on success, -1 on error
+ */
+int
+libkeccak_digest_many(const struct libkeccak_spec *restrict spec, const void *const *restrict msgs,
+                      const size_t *restrict lens, const char *restrict suffix, void *const *restrict hashsums, size_t n)
+{
+	struct libkeccak_state state;
+	if (libkeccak_state_initialise(&state, spec) < 0)
+		return -1;
+	return digest_many(&state, msgs, lens, suffix, hashsums, n);
+}
+
+
+/**
+ * Calculate the hashsums of multiple messages, performing only
+ * the last rounds of Keccak-f, that is Keccak-p
+ * 
+ * Messages are processed several at a time, with their sponges
+ * permuted in parallel, when the word size is at least 8 bits:
+ * four at a time for 1600-bit states, eight for 800-bit states,
+ * sixteen for 400-bit states, and thirty-two for 200-bit states
+ * 
+ * @param   spec      The specifications for the hashing algorithm
+ * @param   rounds    The number of rounds, the last `rounds` of the
+ *                    12 + 2ℓ rounds of Keccak-f are performed
+ * @param   msgs      The messages, an element may be `NULL` if
+ *                    the corresponding element in `lens` is 0
+ * @param   lens      The length of each message, in bytes
+ * @param   suffix    The suffix concatenate to each message, only '1':s and '0':s, and NUL-termination
+ * @param   hashsums  Output parameters for the hashsums
+ * @param   n         The number of messages
+ * @return            Zero on success, -1 on error
+ */
+int
+libkeccak_digest_many_rounds(const struct libkeccak_spec *restrict spec, long int rounds, const void *const *restrict msgs,
+                             const size_t *restrict lens, const char *restrict suffix, void *const *restrict hashsums, size_t n)
+{
+	struct libkeccak_state state;
+	if (libkeccak_state_initialise_rounds(&state, spec, rounds) < 0)
+		return -1;
+	return digest_many(&state, msgs, lens, suffix, hashsums, n);
+}
+
+
+/**
+ * Absorb the same number of whole blocks into two sponges
+ * 
+ * @param  state1    The first hashing state
+ * @param  message1  The bytes to absorb into `state1`
+ * @param  state2    The second hashing state, must have the same bitrate as `state1`
+ * @param  message2  The bytes to absorb into `state2`
+ * @param  len       The number of bytes to absorb into each state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+static void
+libkeccak_absorption_phase_pair(register struct libkeccak_state *restrict state1, register const unsigned char *restrict message1,
+                                register struct libkeccak_state *restrict state2, register const unsigned char *restrict message2,
+                                register size_t len)
+{
+	state1->kernels->absorb_pair(state1, message1, state2, message2, len / (size_t)(state1->r >> 3));
+}
+
+
+/**
+ * Absorb more of two messages into two Keccak sponges,
+ * the blocks the messages have in common are absorbed
+ * into both sponges at once
+ * 
+ * @param  state1   The first hashing state
+ * @param  msg1     The partial message for `state1`
+ * @param  msglen1  The length of `msg1`
+ * @param  state2   The second hashing state, must have the same parameters as `state1`
+ * @param  msg2     The partial message for `state2`
+ * @param  msglen2  The length of `msg2`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1, 4), __nothrow__)))
+static void
+libkeccak_buffered_update_pair(register struct libkeccak_state *restrict state1, const unsigned char *restrict msg1, size_t msglen1,
+                               register struct libkeccak_state *restrict state2, const unsigned char *restrict msg2, size_t msglen2)
+{
+	register size_t rr = (size_t)(state1->r >> 3);
+	register size_t len;
+
+	if (state1->mptr) {
+		len = rr - state1->mptr < msglen1 ? rr - state1->mptr : msglen1;
+		libkeccak_buffered_update(state1, msg1, len);
+		msg1 += len;
+		msglen1 -= len;
+	}
+	if (state2->mptr) {
+		len = rr - state2->mptr < msglen2 ? rr - state2->mptr : msglen2;
+		libkeccak_buffered_update(state2, msg2, len);
+		msg2 += len;
+		msglen2 -= len;
+	}
+
+	len = msglen1 < msglen2 ? msglen1 : msglen2;
+	len -= len % rr;
+	if (len) {
+		libkeccak_absorption_phase_pair(state1, msg1, state2, msg2, len);
+		msg1 += len;
+		msg2 += len;
+		msglen1 -= len;
+		msglen2 -= len;
+	}
+
+	libkeccak_buffered_update(state1, msg1, msglen1);
+	libkeccak_buffered_update(state2, msg2, msglen2);
+}
+
+
+/**
+ * Perform the squeezing phase on two sponges at once
+ * 
+ * @param  state1    The first hashing state
+ * @param  hashsum1  Output parameter for the hashsum of `state1`
+ * @param  state2    The second hashing state, must have the same parameters as `state1`
+ * @param  hashsum2  Output parameter for the hashsum of `state2`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __hot__)))
+static void
+libkeccak_squeezing_phase_pair(register struct libkeccak_state *restrict state1, register unsigned char *restrict hashsum1,
+                               register struct libkeccak_state *restrict state2, register unsigned char *restrict hashsum2)
+{
+	auto long int olen = state1->n;
+	register long int rr = state1->r >> 3;
+	register long int nn = (state1->n + 7) >> 3;
+	register long int len;
+
+	while (olen > 0) {
+		len = nn < rr ? nn : rr;
+		state1->kernels->squeeze(state1, hashsum1, len);
+		state2->kernels->squeeze(state2, hashsum2, len);
+		hashsum1 += len;
+		hashsum2 += len;
+		nn -= len;
+		olen -= state1->r;
+		if (olen > 0)
+			state1->kernels->f_pair(state1, state2);
+	}
+	if (state1->n & 7) {
+		hashsum1[-1] &= (unsigned char)((1 << (state1->n & 7)) - 1);
+		hashsum2[-1] &= (unsigned char)((1 << (state1->n & 7)) - 1);
+	}
+}
+
+
+/**
+ * Absorb the last part of two messages and squeeze the
+ * Keccak sponges, and wipe sensitive data when possible
+ * 
+ * If the states have the same parameters, the blocks the
+ * messages have in common are processed in both states at
+ * once, which can be faster than two calls to `libkeccak_digest`
+ * 
+ * @param   state1    The first hashing state
+ * @param   msg1_     The rest of the first message, may be `NULL`
+ * @param   msglen1   The length of the partial first message
+ * @param   bits1     The number of bits at the end of the first message not covered by `msglen1`
+ * @param   state2    The second hashing state
+ * @param   msg2_     The rest of the second message, may be `NULL`
+ * @param   msglen2   The length of the partial second message
+ * @param   bits2     The number of bits at the end of the second message not covered by `msglen2`
+ * @param   suffix    The suffix concatenate to the messages, only '1':s and '0':s, and NUL-termination
+ * @param   hashsum1  Output parameter for the hashsum of the first message, may be `NULL`
+ * @param   hashsum2  Output parameter for the hashsum of the second message, may be `NULL`
+ * @return            Zero on success, -1 on error
+ */
+int
+libkeccak_digest_pair(struct libkeccak_state *restrict state1, const void *restrict msg1_, size_t msglen1, size_t bits1,
+                      struct libkeccak_state *restrict state2, const void *restrict msg2_, size_t msglen2, size_t bits2,
+                      const char *restrict suffix, void *restrict hashsum1, void *restrict hashsum2)
+{
+	const unsigned char *restrict msg1 = msg1_;
+	const unsigned char *restrict msg2 = msg2_;
+	auto size_t suffix_len = suffix ? __builtin_strlen(suffix) : 0;
+	register long int i;
+
+	if (state1->kernels != state2->kernels || state1->r != state2->r || state1->n != state2->n ||
+	    state1->nr != state2->nr || !hashsum1 != !hashsum2) {
+		if (libkeccak_digest(state1, msg1, msglen1, bits1, suffix, hashsum1) < 0)
+			return -1;
+		return libkeccak_digest(state2, msg2, msglen2, bits2, suffix, hashsum2);
+	}
+
+	if (!msg1) {
+		msglen1 = 0;
+		bits1 = 0;
+	} else {
+		msglen1 += bits1 >> 3;
+		bits1 &= 7;
+	}
+	if (!msg2) {
+		msglen2 = 0;
+		bits2 = 0;
+	} else {
+		msglen2 += bits2 >> 3;
+		bits2 &= 7;
+	}
+
+	libkeccak_buffered_update_pair(state1, msg1, msglen1, state2, msg2, msglen2);
+	if (bits1)
+		state1->M[state1->mptr] = msg1[msglen1];
+	if (bits2)
+		state2->M[state2->mptr] = msg2[msglen2];
+	libkeccak_pad_buffered(state1, bits1, suffix, suffix_len);
+	libkeccak_pad_buffered(state2, bits2, suffix, suffix_len);
+	libkeccak_absorption_phase_pair(state1, state1->M, state2, state2->M, (size_t)(state1->r >> 3));
+	state1->mptr = 0;
+	state2->mptr = 0;
+
+	if (hashsum1) {
+		libkeccak_squeezing_phase_pair(state1, hashsum1, state2, hashsum2);
+	} else {
+		for (i = (state1->n - 1) / state1->r; i--;)
+			state1->kernels->f_pair(state1, state2);
+	}
+
+	libkeccak_state_wipe_message(state1);
+	libkeccak_state_wipe_message(state2);
+	return 0;
 }
@@ -13,13 +13,5 @@ int
 libkeccak_state_copy(struct libkeccak_state *restrict dest, const struct libkeccak_state *restrict src)
 {
 	*dest = *src;
-	if (src->mlen) {
-		dest->M = malloc(src->mlen * sizeof(char));
-		if (!dest->M)
-			return -1;
-		memcpy(dest->M, src->M, src->mptr * sizeof(char));
-	} else {
-		dest->M = NULL;
-	}
 	return 0;
 }
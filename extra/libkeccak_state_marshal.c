@@ -1,4 +1,5 @@
 /* See LICENSE file for copyright and license details. */
+#define NEED_SPONGE_TRANSPOSE 1
 #include "../common.h"
 
 
@@ -42,7 +43,7 @@ libkeccak_state_marshal(const struct libkeccak_state *restrict state, void *rest
 	set(wmod);
 	set(l);
 	set(nr);
-	__builtin_memcpy(data, &state->S, sizeof(state->S));
+	libkeccak_transpose_sponge(data, &state->S, state->w);
 	data += sizeof(state->S);
 	set(mptr);
 	set(mlen);
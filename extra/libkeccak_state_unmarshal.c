@@ -1,4 +1,5 @@
 /* See LICENSE file for copyright and license details. */
+#define NEED_SPONGE_TRANSPOSE 1
 #include "../common.h"
 
 
@@ -26,6 +27,7 @@ libkeccak_state_unmarshal(struct libkeccak_state *restrict state, const void *re
 
 	const unsigned char *restrict start = data_;
 	const unsigned char *restrict data = start;
+	struct libkeccak_spec spec;
 	size_t mptr;
 
 	if (!state) {
@@ -46,19 +48,27 @@ libkeccak_state_unmarshal(struct libkeccak_state *restrict state, const void *re
 	get(wmod);
 	get(l);
 	get(nr);
-	memcpy(&state->S, data, sizeof(state->S));
+	spec.bitrate = state->r;
+	spec.capacity = state->c;
+	spec.output = state->n;
+	if (libkeccak_spec_check(&spec) || state->b != state->r + state->c || state->b != 25 * state->w ||
+	    state->w != 1L << state->l || state->wmod != (state->w == 64 ? ~0ULL : (uint64_t)((1ULL << state->w) - 1)) ||
+	    state->nr < 1 || state->nr > 12 + (state->l << 1)) {
+		errno = EINVAL;
+		return 0;
+	}
+	state->kernels = libkeccak_get_kernels(state->w);
+	libkeccak_transpose_sponge(&state->S, data, state->w);
 	data += sizeof(state->S);
 	get(mptr);
 	get(mlen);
-	if (state->mptr) {
-		state->M = malloc(state->mptr * sizeof(char));
-		if (!state->M)
-			return 0;
-		memcpy(state->M, data, state->mptr * sizeof(char));
-		data += state->mptr;
-	} else {
-		state->M = NULL;
+	if (state->mptr >= (size_t)(state->r >> 3)) {
+		errno = EINVAL;
+		return 0;
 	}
+	state->mlen = sizeof(state->M);
+	memcpy(state->M, data, state->mptr * sizeof(char));
+	data += state->mptr;
 
 	return (size_t)(data - start);
 
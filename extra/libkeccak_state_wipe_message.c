@@ -13,6 +13,6 @@ libkeccak_state_wipe_message(volatile struct libkeccak_state *state)
 	volatile unsigned char *restrict M = state->M;
 	size_t i;
 
-	for (i = 0; i < state->mptr; i++)
+	for (i = 0; i < sizeof(state->M); i++)
 		M[i] = 0;
 }
@@ -3,6 +3,41 @@
 #include "../common.h"
 
 
+
+/**
+ * Absorb the last part of a message, bit-shifted
+ * if the key is not a whole number of bytes, and
+ * squeeze the sponge
+ * 
+ * @param  state    The hashing state
+ * @param  msg      The rest of the message, may be `NULL`
+ * @param  msglen   The length of the partial message
+ * @param  bits     The number of bits at the end of the message not covered by `msglen`
+ * @param  suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
+ * @param  hashsum  Output parameter for the hashsum, may be `NULL`
+ */
+static void
+absorb_last(struct libkeccak_hmac_state *restrict state, const unsigned char *restrict msg, size_t msglen,
+            size_t bits, const char *restrict suffix, void *restrict hashsum)
+{
+	unsigned char leftover[2];
+	size_t newlen;
+
+	if (!(state->key_length & 7)) {
+		libkeccak_digest(&state->sponge, msg, msglen, bits, suffix, hashsum);
+		return;
+	}
+
+	libkeccak_hmac_update(state, msg, msglen);
+	leftover[0] = (unsigned char)(state->leftover & ((1 << (state->key_length & 7)) - 1));
+	if (bits) {
+		leftover[0] |= (unsigned char)(msg[msglen] << (state->key_length & 7));
+		leftover[1] = (unsigned char)((msg[msglen] & ((1 << bits) - 1)) >> (8 - (state->key_length & 7)));
+	}
+	newlen = (state->key_length & 7) + bits;
+	libkeccak_digest(&state->sponge, leftover, newlen >> 3, newlen & 7, suffix, hashsum);
+}
+
 /**
  * Absorb the last part of the message and fetch the hash
  * and wipe sensitive data when possible
@@ -21,61 +56,29 @@ int
 libkeccak_hmac_digest(struct libkeccak_hmac_state *restrict state, const void *restrict msg_, size_t msglen,
                       size_t bits, const char *restrict suffix, void *restrict hashsum)
 {
-	const unsigned char *restrict msg = msg_;
-	size_t hashsize = (size_t)(state->sponge.n >> 3);
-	char *tmp = malloc((size_t)((state->sponge.n + 7) >> 3) * sizeof(char));
-	unsigned char leftover[2];
-	size_t newlen;
+	struct libkeccak_state inner;
+	unsigned char window[sizeof(state->sponge.M)];
+	long int output = state->sponge.n;
+	long int rate = state->sponge.r;
+	size_t byterate = (size_t)rate >> 3;
 
-	if (!tmp)
-		return -1;
-
-	if (!(state->key_length & 7)) {
-		if (libkeccak_digest(&state->sponge, msg, msglen, bits, suffix, tmp) < 0)
-			goto fail;
-		goto stage_2;
-	}
+	/* Only the first block of the inner hash is squeezed here,
+	 * the rest is squeezed from `inner`, one block at a time,
+	 * each block is absorbed into the outer sponge before the
+	 * next is squeezed so that the whole hash is never stored */
+	state->sponge.n = output < rate ? output : rate;
+	absorb_last(state, msg_, msglen, bits, suffix, window);
+	memcpy(&inner, &state->sponge, offsetof(struct libkeccak_state, M));
 
-	if (libkeccak_hmac_update(state, msg, msglen) < 0)
-		goto fail;
-	leftover[0] = state->leftover;
-	if (bits) {
-		leftover[0] |= (unsigned char)(msg[msglen] >> (state->key_length & 7));
-		leftover[1] = (unsigned char)(msg[msglen] << (8 - (state->key_length & 7)));
+	HMAC_LOAD_SPONGE(state, outer);
+	for (; output > rate; output -= rate) {
+		libkeccak_hmac_update(state, window, byterate);
+		inner.n = output - rate < rate ? output - rate : rate;
+		libkeccak_squeeze(&inner, window);
 	}
-	newlen = (state->key_length & 7) + bits;
-	if (libkeccak_digest(&state->sponge, leftover, newlen >> 3, newlen & 7, suffix, tmp) < 0)
-		goto fail;
-
-stage_2:
-	bits = state->sponge.n & 7;
-	state->key_ipad = state->key_opad;
-	if (libkeccak_hmac_update(state, NULL, 0) < 0)
-		goto fail;
-
-	if (!(state->key_length & 7)) {
-		if (libkeccak_digest(&state->sponge, tmp, hashsize, bits, suffix, hashsum) < 0)
-			goto fail;
-		goto stage_3;
-	}
-
-	if (libkeccak_hmac_update(state, tmp, hashsize) < 0)
-		goto fail;
-	leftover[0] = state->leftover;
-	if (bits) {
-		leftover[0] |= (unsigned char)(tmp[hashsize] >> (state->key_length & 7));
-		leftover[1] = (unsigned char)(tmp[hashsize] << (8 - (state->key_length & 7)));
-	}
-	newlen = (state->key_length & 7) + bits;
-	if (libkeccak_digest(&state->sponge, leftover, newlen >> 3, newlen & 7, suffix, tmp) < 0)
-		goto fail;
+	absorb_last(state, window, (size_t)output >> 3, (size_t)output & 7, suffix, hashsum);
 
-stage_3:
-	my_explicit_bzero(tmp, (size_t)((state->sponge.n + 7) >> 3) * sizeof(char));
-	free(tmp);
+	my_explicit_bzero(window, sizeof(window));
+	libkeccak_state_wipe_sponge(&inner);
 	return 0;
-fail:
-	my_explicit_bzero(tmp, (size_t)((state->sponge.n + 7) >> 3) * sizeof(char));
-	free(tmp);
-	return -1;
 }
@@ -0,0 +1,57 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Absorb the last part of two messages and fetch their
+ * hashes, and wipe sensitive data when possible
+ * 
+ * @param   state1    The first hashing state
+ * @param   msg1      The rest of the first message, may be `NULL`, may be modified
+ * @param   msglen1   The length of the partial first message
+ * @param   bits1     The number of bits at the end of the first message not covered by `msglen1`
+ * @param   state2    The second hashing state
+ * @param   msg2      The rest of the second message, may be `NULL`, may be modified
+ * @param   msglen2   The length of the partial second message
+ * @param   bits2     The number of bits at the end of the second message not covered by `msglen2`
+ * @param   suffix    The suffix concatenate to the messages, only '1':s and '0':s, and NUL-termination
+ * @param   hashsum1  Output parameter for the hashsum of the first message, may be `NULL`
+ * @param   hashsum2  Output parameter for the hashsum of the second message, may be `NULL`
+ * @return            Zero on success, -1 on error
+ */
+int
+libkeccak_hmac_digest_pair(struct libkeccak_hmac_state *restrict state1, const void *restrict msg1, size_t msglen1,
+                           size_t bits1, struct libkeccak_hmac_state *restrict state2, const void *restrict msg2,
+                           size_t msglen2, size_t bits2, const char *restrict suffix, void *restrict hashsum1,
+                           void *restrict hashsum2)
+{
+	size_t hashsize = (size_t)(state1->sponge.n >> 3);
+	size_t bits = (size_t)(state1->sponge.n & 7);
+	unsigned char tmp1[sizeof(state1->sponge.M)];
+	unsigned char tmp2[sizeof(state2->sponge.M)];
+
+	/* The bit-shifting needed for unaligned keys, and the block-wise
+	 * squeezing needed for hashes longer than a block, is done by
+	 * `libkeccak_hmac_digest` */
+	if ((state1->key_length | state2->key_length) & 7 || state1->sponge.kernels != state2->sponge.kernels ||
+	    state1->sponge.r != state2->sponge.r || state1->sponge.n != state2->sponge.n ||
+	    state1->sponge.nr != state2->sponge.nr || state1->sponge.n > state1->sponge.r) {
+		if (libkeccak_hmac_digest(state1, msg1, msglen1, bits1, suffix, hashsum1) < 0)
+			return -1;
+		return libkeccak_hmac_digest(state2, msg2, msglen2, bits2, suffix, hashsum2);
+	}
+
+	libkeccak_digest_pair(&state1->sponge, msg1, msglen1, bits1, &state2->sponge, msg2, msglen2, bits2,
+	                      suffix, tmp1, tmp2);
+
+	HMAC_LOAD_SPONGE(state1, outer);
+	HMAC_LOAD_SPONGE(state2, outer);
+
+	libkeccak_digest_pair(&state1->sponge, tmp1, hashsize, bits, &state2->sponge, tmp2, hashsize, bits,
+	                      suffix, hashsum1, hashsum2);
+
+	my_explicit_bzero(tmp1, sizeof(tmp1));
+	my_explicit_bzero(tmp2, sizeof(tmp2));
+	return 0;
+}
@@ -1,4 +1,5 @@
 /* See LICENSE file for copyright and license details. */
+#define NEED_SHIFT_MESSAGE 1
 #include "../common.h"
 
 
@@ -15,17 +16,9 @@ int
 libkeccak_hmac_fast_update(struct libkeccak_hmac_state *restrict state, const void *restrict msg_, size_t msglen)
 {
 	const unsigned char *restrict msg = msg_;
-	void *new;
-	size_t i;
-	int n, cn;
-
-	if (state->key_ipad) {
-		if (libkeccak_fast_update(&state->sponge, state->key_ipad, state->key_length >> 3) < 0)
-			return -1;
-		if (state->key_length & 7)
-			state->leftover = state->key_ipad[state->key_length >> 3];
-		state->key_ipad = NULL;
-	}
+	unsigned char window[sizeof(state->sponge.M)];
+	size_t len;
+	int n;
 
 	if (!msg || !msglen)
 		return 0;
@@ -33,20 +26,14 @@ libkeccak_hmac_fast_update(struct libkeccak_hmac_state *restrict state, const vo
 	if (!(state->key_length & 7))
 		return libkeccak_fast_update(&state->sponge, msg, msglen);
 
-	if (msglen != state->buffer_size) {
-		new = realloc(state->buffer, msglen);
-		if (!new)
-			return -1;
-		state->buffer = new;
-		state->buffer_size = msglen;
-	}
-
+	/* The message is shifted into a fixed-size window,
+	 * which is absorbed before the next part is shifted */
 	n = (int)(state->key_length & 7);
-	cn = 8 - n;
-	for (i = 1; i < msglen; i++)
-		state->buffer[i] = (unsigned char)((msg[i - 1] >> cn) | (msg[i] << n));
-	state->buffer[0] = (unsigned char)((state->leftover & ((1 << n) - 1)) | (msg[0] << n));
-	state->leftover = (unsigned char)(msg[msglen - 1] >> cn);
+	for (; msglen; msg += len, msglen -= len) {
+		len = msglen < sizeof(window) ? msglen : sizeof(window);
+		state->leftover = shift_message(window, msg, len, state->leftover, n);
+		libkeccak_fast_update(&state->sponge, window, len);
+	}
 
-	return libkeccak_fast_update(&state->sponge, state->buffer, msglen);
+	return 0;
 }
@@ -2,4 +2,20 @@
 #include "../common.h"
 
 
-extern inline int libkeccak_hmac_reset(struct libkeccak_hmac_state *restrict, const void *restrict, size_t);
+/**
+ * Reset an HMAC-hashing state according to hashing specifications,
+ * you can choose whether to change the key
+ * 
+ * @param   state       The state that should be reset
+ * @param   key         The new key, `NULL` to keep the old key
+ * @param   key_length  The length of key, in bits, ignored if `key == NULL`
+ * @return              Zero on success, -1 on error
+ */
+int
+libkeccak_hmac_reset(struct libkeccak_hmac_state *restrict state, const void *restrict key, size_t key_length)
+{
+	if (key)
+		return libkeccak_hmac_set_key(state, key, key_length);
+	HMAC_LOAD_SPONGE(state, inner);
+	return 0;
+}
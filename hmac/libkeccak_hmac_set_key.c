@@ -1,47 +1,58 @@
 /* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
 #include "../common.h"
 
 
 /**
- * Change the HMAC-hashing key on the state
+ * Change the HMAC-hashing key on the state, and
+ * start hashing a new message with the new key
  * 
  * @param   state       The state that should be reset
- * @param   key         The new key
+ * @param   key_        The new key
  * @param   key_length  The length of key, in bits
  * @return              Zero on success, -1 on error
  */
 int
-libkeccak_hmac_set_key(struct libkeccak_hmac_state *restrict state, const void *restrict key, size_t key_length)
+libkeccak_hmac_set_key(struct libkeccak_hmac_state *restrict state, const void *restrict key_, size_t key_length)
 {
-	size_t i, size, new_key_length, key_bytes;
-	void *new;
-
-	size = (size_t)(state->sponge.r) > key_length ? (size_t)(state->sponge.r) : key_length;
-	new_key_length = size;
-	size = (size + 7) >> 3;
-	key_bytes = (key_length + 7) >> 3;
-
-	if (size != key_bytes) {
-		new = realloc(state->key_opad, 2 * size);
-		if (!new)
-			return -1;
-		state->key_opad = new;
-		state->key_ipad = state->key_opad + size;
+	const unsigned char *restrict key = key_;
+	unsigned char ipad[sizeof(state->sponge.M)];
+	unsigned char opad[sizeof(state->sponge.M)];
+	size_t i, n, off, size, key_bytes, byterate;
+	unsigned char k, last;
+
+	byterate = (size_t)state->sponge.r >> 3;
+	state->key_length = (size_t)state->sponge.r > key_length ? (size_t)state->sponge.r : key_length;
+	size = state->key_length >> 3;
+	key_bytes = key_length >> 3;
+
+	last = (key_length & 7) ? (unsigned char)(key[key_bytes] & ((1 << (key_length & 7)) - 1)) : 0;
+
+	memcpy(&state->inner, &state->sponge, offsetof(struct libkeccak_state, M));
+	libkeccak_state_reset(&state->inner);
+	memcpy(&state->outer, &state->inner, offsetof(struct libkeccak_state, M));
+
+	/* The padded key is XOR:ed with the pads and absorbed
+	 * one block at a time, so that it is never stored */
+	for (off = 0; off < size; off += n) {
+		n = size - off < byterate ? size - off : byterate;
+		for (i = 0; i < n; i++) {
+			k = off + i < key_bytes ? key[off + i] : off + i == key_bytes ? last : 0;
+			ipad[i] = (unsigned char)(k ^ HMAC_INNER_PAD);
+			opad[i] = (unsigned char)(k ^ HMAC_OUTER_PAD);
+		}
+		libkeccak_update(&state->inner, ipad, n);
+		libkeccak_update(&state->outer, opad, n);
 	}
 
-	memcpy(state->key_opad, key, key_bytes);
-	if (key_length & 7)
-		state->key_opad[(key_bytes >> 3) - 1] &= (unsigned char)((1 << (key_length & 7)) - 1);
+	/* If the key is longer than a block, the bits of it that do not
+	 * make up a whole byte are prepended to the message, see `.leftover` */
+	state->inner_leftover = (unsigned char)(last ^ HMAC_INNER_PAD);
+	state->outer_leftover = (unsigned char)(last ^ HMAC_OUTER_PAD);
 
-	if ((size_t)(state->sponge.r) > key_length)
-		__builtin_memset(state->key_opad + key_bytes, 0, size - key_bytes);
-
-	for (i = 0; i < size; i++) {
-		state->key_ipad[i] = state->key_opad[i] ^ HMAC_INNER_PAD;
-		state->key_opad[i] ^= HMAC_OUTER_PAD;
-	}
-
-	state->key_length = new_key_length;
+	my_explicit_bzero(ipad, sizeof(ipad));
+	my_explicit_bzero(opad, sizeof(opad));
 
+	HMAC_LOAD_SPONGE(state, inner);
 	return 0;
 }
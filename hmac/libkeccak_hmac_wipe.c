@@ -10,15 +10,10 @@
 void
 libkeccak_hmac_wipe(volatile struct libkeccak_hmac_state *state)
 {
-	volatile unsigned char *restrict key_pads;
-	size_t i, size;
-
-	key_pads = state->key_opad;
-	size = 2 * ((state->key_length + 7) >> 3);
-
 	libkeccak_state_wipe(&state->sponge);
-	for (i = 0; i < size; i++)
-		key_pads[i] = 0;
+	libkeccak_state_wipe(&state->inner);
+	libkeccak_state_wipe(&state->outer);
 	state->leftover = 0;
-	__builtin_memset(state->buffer, 0, state->buffer_size);
+	state->inner_leftover = 0;
+	state->outer_leftover = 0;
 }
@@ -0,0 +1,20 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Add a job to the queue of completed jobs
+ * 
+ * @param  manager  The job manager
+ * @param  job      The completed job
+ */
+void
+libkeccak_job_complete(struct libkeccak_job_manager *restrict manager, struct libkeccak_job *restrict job)
+{
+	job->next = NULL;
+	if (manager->completed_last)
+		manager->completed_last->next = job;
+	else
+		manager->completed = job;
+	manager->completed_last = job;
+}
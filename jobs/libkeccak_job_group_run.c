@@ -0,0 +1,64 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Block to absorb into idle lanes
+ */
+static const unsigned char zero_block[200];
+
+
+/**
+ * Process the jobs in a group until at least one of them
+ * completes, and move completed jobs to the queue of
+ * completed jobs; idle lanes absorb blocks of zeroes
+ * 
+ * @param  manager  The job manager
+ * @param  group    The group, must have at least one job
+ */
+void
+libkeccak_job_group_run(struct libkeccak_job_manager *restrict manager, register struct libkeccak_job_group *restrict group)
+{
+	const struct libkeccak_multi *multi = group->multi;
+	const unsigned char *block[MAX_WAYS];
+	struct libkeccak_state state;
+	register size_t k, ways = (size_t)multi->ways, rr = (size_t)(group->r >> 3);
+	size_t steps = SIZE_MAX, j;
+
+	for (k = 0; k < ways; k++)
+		if (group->job[k] && group->blocks[k] - group->next[k] < steps)
+			steps = group->blocks[k] - group->next[k];
+
+	while (steps--) {
+		for (k = 0; k < ways; k++) {
+			j = group->next[k]++;
+			if (!group->job[k])
+				block[k] = zero_block;
+			else if (j < group->full[k])
+				block[k] = &((const unsigned char *)group->job[k]->msg)[j * rr];
+			else
+				block[k] = &group->pad[k][(j - group->full[k]) * rr];
+		}
+		multi->absorb(&group->S, block, (long int)rr, group->nr);
+	}
+
+	for (k = 0; k < ways; k++) {
+		if (!group->job[k]) {
+			group->next[k] = 0;
+			continue;
+		}
+		if (group->next[k] != group->blocks[k])
+			continue;
+		libkeccak_state_initialise(&state, group->job[k]->spec);
+		multi->extract(&state, &group->S, (long int)k);
+		libkeccak_squeezing_phase(&state, state.r >> 3, (state.n + 7) >> 3, group->job[k]->hashsum);
+		libkeccak_state_wipe_sponge(&state);
+		libkeccak_job_complete(manager, group->job[k]);
+		group->job[k] = NULL;
+		group->next[k] = 0;
+		group->active--;
+	}
+
+	if (!group->active)
+		group->multi = NULL;
+}
@@ -0,0 +1,15 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Create a job manager
+ * 
+ * @return  The job manager, `NULL` on error
+ */
+struct libkeccak_job_manager *
+libkeccak_job_manager_create(void)
+{
+	struct libkeccak_job_manager *manager = calloc(1, sizeof(*manager));
+	return manager;
+}
@@ -0,0 +1,29 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Get a completed job, and if none is available, process
+ * submitted jobs, with the lanes that are not filled left
+ * idle, until at least one job completes
+ * 
+ * @param   manager  The job manager
+ * @return           A completed job, `NULL` if there are
+ *                   no submitted jobs left
+ */
+struct libkeccak_job *
+libkeccak_job_manager_flush(struct libkeccak_job_manager *manager)
+{
+	struct libkeccak_job_group *group = NULL;
+	size_t i;
+
+	if (!manager->completed) {
+		for (i = 0; i < JOB_GROUPS; i++)
+			if (manager->groups[i].multi && (!group || manager->groups[i].active > group->active))
+				group = &manager->groups[i];
+		if (group)
+			libkeccak_job_group_run(manager, group);
+	}
+
+	return libkeccak_job_manager_get_completed(manager);
+}
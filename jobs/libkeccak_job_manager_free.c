@@ -0,0 +1,19 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Wipe sensitive data and deallocate a job manager,
+ * jobs that have not been completed are abandoned
+ * 
+ * @param  manager  The job manager, may be `NULL`
+ */
+void
+libkeccak_job_manager_free(struct libkeccak_job_manager *manager)
+{
+	if (manager) {
+		my_explicit_bzero(manager, sizeof(*manager));
+		free(manager);
+	}
+}
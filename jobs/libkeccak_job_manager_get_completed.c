@@ -0,0 +1,22 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Get a completed job, without processing any submitted jobs
+ * 
+ * @param   manager  The job manager
+ * @return           A completed job, `NULL` if none is available
+ */
+struct libkeccak_job *
+libkeccak_job_manager_get_completed(struct libkeccak_job_manager *manager)
+{
+	struct libkeccak_job *job = manager->completed;
+	if (job) {
+		manager->completed = job->next;
+		if (!manager->completed)
+			manager->completed_last = NULL;
+		job->next = NULL;
+	}
+	return job;
+}
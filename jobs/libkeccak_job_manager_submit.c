@@ -0,0 +1,76 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Submit a job to a job manager
+ * 
+ * Jobs whose sponges can be permuted in parallel are processed
+ * together; if all lanes for the job's algorithm are filled,
+ * the sponges are processed until at least one job completes
+ * 
+ * @param   manager  The job manager
+ * @param   job      The job, must not be modified until it is
+ *                   returned by `libkeccak_job_manager_get_completed`
+ *                   or `libkeccak_job_manager_flush`
+ * @return           Zero on success, -1 on error
+ */
+int
+libkeccak_job_manager_submit(struct libkeccak_job_manager *restrict manager, struct libkeccak_job *restrict job)
+{
+	struct libkeccak_state state;
+	struct libkeccak_job_group *group = NULL;
+	const struct libkeccak_multi *multi;
+	const unsigned char *msg = job->msg;
+	size_t suffix_len = job->suffix ? __builtin_strlen(job->suffix) : 0;
+	size_t i, k, rr, padded;
+
+	if (libkeccak_state_initialise(&state, job->spec) < 0)
+		return -1;
+	rr = (size_t)(state.r >> 3);
+
+	multi = libkeccak_get_multi(state.w);
+	if (!multi || suffix_len > rr * 8) {
+		libkeccak_digest(&state, msg, job->msglen, 0, job->suffix, job->hashsum);
+		libkeccak_state_wipe_sponge(&state);
+		libkeccak_job_complete(manager, job);
+		return 0;
+	}
+
+	for (i = 0; i < JOB_GROUPS; i++) {
+		if (manager->groups[i].multi == multi && manager->groups[i].r == state.r && manager->groups[i].nr == state.nr) {
+			group = &manager->groups[i];
+			break;
+		}
+		if (!manager->groups[i].multi && !group)
+			group = &manager->groups[i];
+	}
+	if (!group) {
+		/* All groups are used for other algorithms, finish the one with the fewest jobs */
+		group = &manager->groups[0];
+		for (i = 1; i < JOB_GROUPS; i++)
+			if (manager->groups[i].active < group->active)
+				group = &manager->groups[i];
+		while (group->multi)
+			libkeccak_job_group_run(manager, group);
+	}
+	if (!group->multi) {
+		group->multi = multi;
+		group->r = state.r;
+		group->nr = state.nr;
+	}
+
+	for (k = 0; group->job[k]; k++);
+	group->job[k] = job;
+	group->full[k] = job->msglen / rr;
+	padded = libkeccak_pad_final((size_t)state.r, group->pad[k], msg ? &msg[group->full[k] * rr] : NULL,
+	                             job->msglen % rr, 0, job->suffix, suffix_len);
+	group->blocks[k] = group->full[k] + padded / rr;
+	group->next[k] = 0;
+	multi->clear(&group->S, (long int)k);
+	group->active++;
+
+	if (group->active == (size_t)multi->ways)
+		libkeccak_job_group_run(manager, group);
+	return 0;
+}
@@ -0,0 +1,25 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Release resources allocation for a KangarooTwelve
+ * hashing state and wipe sensitive data
+ * 
+ * @param  state  The state that should be destroyed, may be `NULL`
+ */
+void
+libkeccak_k12_destroy(struct libkeccak_k12_state *state)
+{
+	if (!state)
+		return;
+	if (state->buffer) {
+		my_explicit_bzero(state->buffer, state->capacity * LIBKECCAK_K12_CHUNK_SIZE);
+		my_explicit_bzero(state->cvs, state->capacity * (size_t)state->semicapacity / 4);
+		free(state->buffer);
+		free(state->cvs);
+		state->buffer = state->cvs = NULL;
+	}
+	libkeccak_state_destroy(&state->final);
+}
@@ -0,0 +1,90 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Message suffix for a message that fits in one
+ * chunk, the domain separation byte is 0x07
+ */
+#define SINGLE_SUFFIX "11"
+
+/**
+ * Message suffix for the final node of a message
+ * of multiple chunks, the domain separation byte is 0x06
+ */
+#define FINAL_SUFFIX "01"
+
+
+/**
+ * Encode an integer as KangarooTwelve's `length_encode`,
+ * the bytes of the integer in big-endian order without
+ * leading zeroes, followed by the number of those bytes
+ * 
+ * @param   buf    Output buffer, must have room for `sizeof(size_t) + 1` bytes
+ * @param   value  The integer to encode
+ * @return         The number of bytes written to `buf`
+ */
+static size_t
+length_encode(unsigned char *buf, size_t value)
+{
+	size_t n = 0, i;
+	unsigned char byte;
+
+	for (; value; value >>= 8)
+		buf[n++] = (unsigned char)value;
+	for (i = 0; i < n / 2; i++) {
+		byte = buf[i];
+		buf[i] = buf[n - 1 - i];
+		buf[n - 1 - i] = byte;
+	}
+	buf[n] = (unsigned char)n;
+	return n + 1;
+}
+
+
+/**
+ * Absorb the last part of the message and the customisation
+ * string, and squeeze the KangarooTwelve hashing state
+ * 
+ * @param   state      The hashing state
+ * @param   msg        The rest of the message, may be `NULL`
+ * @param   msglen     The length of the partial message, in bytes
+ * @param   custom     The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen  The length of the customisation string, in bytes
+ * @param   hashsum    Output parameter for the hashsum, may be `NULL`
+ * @return             Zero on success, -1 on error
+ */
+int
+libkeccak_k12_digest(struct libkeccak_k12_state *restrict state, const void *restrict msg, size_t msglen,
+                     const void *restrict custom, size_t customlen, void *restrict hashsum)
+{
+	unsigned char encoded[sizeof(size_t) + 3];
+	size_t n;
+	int r;
+
+	if (libkeccak_k12_update(state, msg, msglen) < 0 ||
+	    libkeccak_k12_update(state, custom, customlen) < 0)
+		return -1;
+	n = length_encode(encoded, customlen);
+	if (libkeccak_k12_update(state, encoded, n) < 0)
+		return -1;
+
+	if (!state->buffer)
+		return libkeccak_digest(&state->final, NULL, 0, 0, SINGLE_SUFFIX, hashsum);
+
+	if (libkeccak_k12_hash_leaves(state, state->buffer, state->buffered) < 0)
+		return -1;
+	n = length_encode(encoded, state->leaves);
+	encoded[n++] = 0xFF;
+	encoded[n++] = 0xFF;
+	r = libkeccak_digest(&state->final, encoded, n, 0, FINAL_SUFFIX, hashsum);
+
+	my_explicit_bzero(state->buffer, state->capacity * LIBKECCAK_K12_CHUNK_SIZE);
+	my_explicit_bzero(state->cvs, state->capacity * (size_t)state->semicapacity / 4);
+	free(state->buffer);
+	free(state->cvs);
+	state->buffer = state->cvs = NULL;
+	state->buffered = 0;
+	return r;
+}
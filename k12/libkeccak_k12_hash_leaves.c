@@ -0,0 +1,42 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Message suffix for the leaves, the
+ * domain separation byte is 0x0B
+ */
+#define LEAF_SUFFIX "110"
+
+
+/**
+ * Hash KangarooTwelve leaves and absorb their
+ * chaining values into the final node
+ * 
+ * @param   state  The hashing state
+ * @param   data   The chunks, all but the last must be whole
+ * @param   len    The number of bytes in `data`
+ * @return         Zero on success, -1 on error
+ */
+int
+libkeccak_k12_hash_leaves(struct libkeccak_k12_state *restrict state, const unsigned char *restrict data, size_t len)
+{
+	struct libkeccak_spec spec;
+	size_t n, count, cvlen = (size_t)state->semicapacity / 4;
+
+	libkeccak_spec_shake(&spec, state->semicapacity, (long int)cvlen * 8);
+
+	while (len) {
+		n = len < state->capacity * LIBKECCAK_K12_CHUNK_SIZE ? len : state->capacity * LIBKECCAK_K12_CHUNK_SIZE;
+		count = (n + LIBKECCAK_K12_CHUNK_SIZE - 1) / LIBKECCAK_K12_CHUNK_SIZE;
+		libkeccak_worker_pool_hash_leaves(state->pool, &spec, LIBKECCAK_TURBOSHAKE_ROUNDS, LEAF_SUFFIX,
+		                                  data, n, LIBKECCAK_K12_CHUNK_SIZE, state->cvs);
+		if (libkeccak_update(&state->final, state->cvs, count * cvlen) < 0)
+			return -1;
+		state->leaves += count;
+		data = &data[n];
+		len -= n;
+	}
+
+	return 0;
+}
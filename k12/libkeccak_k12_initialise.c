@@ -0,0 +1,37 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Initialise a KangarooTwelve hashing state
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `KTx`, 128 for KT128
+ *                        (KangarooTwelve) or 256 for KT256
+ * @param   output        The output size, in bits
+ * @param   pool          Worker pool used to hash the leaves,
+ *                        `NULL` to use only the calling thread
+ * @return                Zero on success, -1 on error
+ */
+int
+libkeccak_k12_initialise(struct libkeccak_k12_state *restrict state, long int semicapacity, long int output,
+                         struct libkeccak_worker_pool *pool)
+{
+	if ((semicapacity != 128 && semicapacity != 256) || output <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (libkeccak_turboshake_initialise(&state->final, semicapacity, output) < 0)
+		return -1;
+
+	state->buffer = NULL;
+	state->cvs = NULL;
+	state->buffered = 0;
+	state->capacity = K12_CHUNKS_PER_THREAD * (pool ? pool->nthreads + 1 : 1);
+	state->first = 0;
+	state->leaves = 0;
+	state->semicapacity = semicapacity;
+	state->pool = pool;
+	return 0;
+}
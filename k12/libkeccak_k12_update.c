@@ -0,0 +1,81 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * The chunk delimiter that follows the first chunk
+ * in the final node when there is more than one chunk
+ */
+static const unsigned char delimiter[8] = {0x03, 0, 0, 0, 0, 0, 0, 0};
+
+
+/**
+ * Absorb more of the message to a KangarooTwelve hashing state
+ * 
+ * @param   state   The hashing state
+ * @param   msg_    The partial message
+ * @param   msglen  The length of the partial message, in bytes
+ * @return          Zero on success, -1 on error
+ */
+int
+libkeccak_k12_update(struct libkeccak_k12_state *restrict state, const void *restrict msg_, size_t msglen)
+{
+	const unsigned char *restrict msg = msg_;
+	size_t n, size = state->capacity * LIBKECCAK_K12_CHUNK_SIZE;
+	int started;
+
+	if (!msglen)
+		return 0;
+
+	started = !state->buffer && msglen > LIBKECCAK_K12_CHUNK_SIZE - state->first;
+	if (started) {
+		state->buffer = malloc(size);
+		state->cvs = malloc(state->capacity * (size_t)state->semicapacity / 4);
+		if (!state->buffer || !state->cvs) {
+			free(state->buffer);
+			free(state->cvs);
+			state->buffer = state->cvs = NULL;
+			return -1;
+		}
+	}
+
+	if (state->first < LIBKECCAK_K12_CHUNK_SIZE) {
+		n = LIBKECCAK_K12_CHUNK_SIZE - state->first;
+		n = msglen < n ? msglen : n;
+		if (libkeccak_update(&state->final, msg, n) < 0)
+			return -1;
+		state->first += n;
+		msg = &msg[n];
+		msglen -= n;
+	}
+	if (started && libkeccak_update(&state->final, delimiter, sizeof(delimiter)) < 0)
+		return -1;
+	if (!msglen)
+		return 0;
+
+	if (state->buffered) {
+		n = size - state->buffered;
+		n = msglen < n ? msglen : n;
+		__builtin_memcpy(&state->buffer[state->buffered], msg, n);
+		state->buffered += n;
+		msg = &msg[n];
+		msglen -= n;
+		if (state->buffered < size)
+			return 0;
+		if (libkeccak_k12_hash_leaves(state, state->buffer, size) < 0)
+			return -1;
+		state->buffered = 0;
+	}
+
+	n = msglen - msglen % size;
+	if (n) {
+		if (libkeccak_k12_hash_leaves(state, msg, n) < 0)
+			return -1;
+		msg = &msg[n];
+		msglen -= n;
+	}
+
+	__builtin_memcpy(state->buffer, msg, msglen);
+	state->buffered = msglen;
+	return 0;
+}
@@ -0,0 +1,30 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_RIGHT_ENCODE 1
+#include "../common.h"
+
+
+/**
+ * Absorb the last part of the message and squeeze
+ * the KMAC hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   msg      The rest of the message, may be `NULL`
+ * @param   msglen   The length of the partial message, in bytes
+ * @param   xof      Non-zero for KMACXOF, where the output
+ *                   does not depend on the output size
+ * @param   hashsum  Output parameter for the hashsum, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+int
+libkeccak_kmac_digest(struct libkeccak_kmac_state *restrict state, const void *restrict msg, size_t msglen,
+                      int xof, void *restrict hashsum)
+{
+	unsigned char encoded[sizeof(uintmax_t) + 1];
+	size_t n;
+
+	if (msglen)
+		libkeccak_update(&state->sponge, msg, msglen);
+	n = right_encode(encoded, xof ? 0 : (uintmax_t)state->sponge.n);
+	return libkeccak_digest(&state->sponge, encoded, n, 0,
+	                        libkeccak_cshake_suffix(sizeof(KMAC_FUNCTION_NAME) - 1, 0), hashsum);
+}
@@ -0,0 +1,52 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_LEFT_ENCODE 1
+#include "../common.h"
+
+
+/**
+ * Initialise a KMAC hashing state and absorb the key
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `KMACx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   key           The key, may be `NULL` if `keylen` is 0
+ * @param   keylen        The length of the key, in bytes
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @return                Zero on success, -1 on error
+ */
+int
+libkeccak_kmac_initialise(struct libkeccak_kmac_state *restrict state, long int semicapacity, long int output,
+                          const void *restrict key, size_t keylen, const void *restrict custom, size_t customlen)
+{
+	static const unsigned char zeroes[200] = {0};
+	struct libkeccak_spec spec;
+	unsigned char encoded[2 * (sizeof(uintmax_t) + 1)];
+	size_t n, rr;
+
+	if ((semicapacity != 128 && semicapacity != 256) || output <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	libkeccak_spec_cshake(&spec, semicapacity, output);
+	if (libkeccak_state_initialise(&state->keyed, &spec) < 0)
+		return -1;
+	libkeccak_cshake_initialise(&state->keyed, KMAC_FUNCTION_NAME, sizeof(KMAC_FUNCTION_NAME) - 1, 0, NULL,
+	                            custom, customlen, 0, NULL);
+
+	/* bytepad(encode_string(key), rate) */
+	rr = (size_t)state->keyed.r >> 3;
+	n = left_encode(encoded, rr);
+	n += left_encode(&encoded[n], (uintmax_t)keylen * 8);
+	libkeccak_update(&state->keyed, encoded, n);
+	if (keylen)
+		libkeccak_update(&state->keyed, key, keylen);
+	n = (n + keylen) % rr;
+	if (n)
+		libkeccak_update(&state->keyed, zeroes, rr - n);
+	libkeccak_state_wipe_message(&state->keyed);
+
+	libkeccak_kmac_reset(state);
+	return 0;
+}
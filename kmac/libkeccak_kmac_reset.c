@@ -0,0 +1,18 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Reset a KMAC hashing state so that a new
+ * message can be hashed with the same key
+ * 
+ * This only copies the sponge, the key
+ * is not absorbed again
+ * 
+ * @param  state  The hashing state
+ */
+void
+libkeccak_kmac_reset(struct libkeccak_kmac_state *state)
+{
+	libkeccak_state_copy_unbuffered(&state->sponge, &state->keyed);
+}
@@ -0,0 +1,5 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+extern inline int libkeccak_kmac_update(struct libkeccak_kmac_state *restrict, const void *restrict, size_t);
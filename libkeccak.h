@@ -54,6 +54,12 @@ struct libkeccak_spec {
 };
 
 
+/**
+ * Internal description of the routines used for a state
+ */
+struct libkeccak_kernels;
+
+
 /**
  * Data structure that describes the state of a hashing process
  * 
@@ -61,7 +67,7 @@ struct libkeccak_spec {
  */
 struct libkeccak_state {
 	/**
-	 * The lanes (state/sponge)
+	 * The lanes (state/sponge), lane (x, y) is stored at index x + 5y
 	 */
 	union {
 		uint64_t w64[25];
@@ -106,10 +112,18 @@ struct libkeccak_state {
 	long int l;
 
 	/**
-	 * 12 + 2ℓ, the number of rounds
+	 * The number of rounds performed by each permutation,
+	 * 12 + 2ℓ, or fewer if the state was initialised with
+	 * `libkeccak_state_initialise_rounds`
 	 */
 	long int nr;
 
+	/**
+	 * The permutation, absorb and squeeze routines
+	 * for the word size, for internal use
+	 */
+	const struct libkeccak_kernels *kernels;
+
 	/**
 	 * Pointer for `M`
 	 */
@@ -121,9 +135,10 @@ struct libkeccak_state {
 	size_t mlen;
 
 	/**
-	 * Left over water to fill the sponge with at next update
+	 * Left over water to fill the sponge with at next update,
+	 * never more than one block is buffered
 	 */
-	unsigned char *M;
+	unsigned char M[200];
 };
 
 
@@ -137,6 +152,19 @@ struct libkeccak_state {
 LIBKECCAK_GCC_ONLY(__attribute__((__leaf__, __nonnull__)))
 int libkeccak_state_initialise(struct libkeccak_state *, const struct libkeccak_spec *);
 
+/**
+ * Initialise a state according to hashing specifications,
+ * performing only the last rounds of Keccak-f, that is Keccak-p
+ * 
+ * @param   state   The state that should be initialised
+ * @param   spec    The specifications for the state
+ * @param   rounds  The number of rounds, the last `rounds` of the
+ *                  12 + 2ℓ rounds of Keccak-f are performed
+ * @return          Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
+int libkeccak_state_initialise_rounds(struct libkeccak_state *, const struct libkeccak_spec *, long int);
+
 /**
  * Get the number of bytes that are absorbed during
  * one pass of the absorption phase
@@ -153,42 +181,44 @@ libkeccak_zerocopy_chunksize(struct libkeccak_state *state)
 
 /**
  * Absorb more of the message to the Keccak sponge
- * without copying the data to an internal buffer
+ * without copying whole blocks to an internal buffer
  * 
- * It is safe to run zero-copy functions before non-zero-copy
- * functions for the same state, running zero-copy functions
- * after non-zero-copy functions on the other hand can
- * cause the message to be misread
+ * This is equivalent to `libkeccak_fast_update`, which
+ * also absorbs whole blocks directly from `msg`
  * 
  * @param  state   The hashing state
  * @param  msg     The partial message
- * @param  msglen  The length of the partial message; must be a
- *                 multiple of `libkeccak_zerocopy_chunksize(state)`
- *                 (undefined behaviour otherwise)
+ * @param  msglen  The length of the partial message
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
 void libkeccak_zerocopy_update(struct libkeccak_state *restrict, const void *restrict, size_t);
 
 /**
  * Absorb more of the message to the Keccak sponge
- * without wiping sensitive data when possible
+ * 
+ * Whole blocks are absorbed directly from `msg`, and
+ * less than one block is kept in `state->M`, so no
+ * memory is allocated and nothing needs to be wiped
  * 
  * @param   state   The hashing state
  * @param   msg     The partial message
  * @param   msglen  The length of the partial message
- * @return          Zero on success, -1 on error
+ * @return          Zero
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
 int libkeccak_fast_update(struct libkeccak_state *restrict, const void *restrict, size_t);
 
 /**
  * Absorb more of the message to the Keccak sponge
- * and wipe sensitive data when possible
+ * 
+ * Whole blocks are absorbed directly from `msg`, and
+ * less than one block is kept in `state->M`, so no
+ * memory is allocated and nothing needs to be wiped
  * 
  * @param   state   The hashing state
  * @param   msg     The partial message
  * @param   msglen  The length of the partial message
- * @return          Zero on success, -1 on error
+ * @return          Zero
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
 int libkeccak_update(struct libkeccak_state *restrict, const void *restrict, size_t);
@@ -197,22 +227,17 @@ int libkeccak_update(struct libkeccak_state *restrict, const void *restrict, siz
  * Absorb the last part of the message and squeeze the Keccak sponge
  * without copying the data to an internal buffer
  * 
- * It is safe to run zero-copy functions before non-zero-copy
- * functions for the same state, running zero-copy functions
- * after non-zero-copy functions on the other hand can
- * cause the message to be misread
+ * This is equivalent to `libkeccak_fast_digest`, which also
+ * absorbs whole blocks directly from `msg`; `msg` is not modified
  * 
  * @param  state    The hashing state
- * @param  msg      The rest of the message; will be edited; extra memory
- *                  shall be allocated such that `suffix` and a 10*1 pad (which
- *                  is at least 2 bits long) can be added in a way that makes its
- *                  length a multiple of `libkeccak_zerocopy_chunksize(state)`
+ * @param  msg      The rest of the message, may be `NULL`
  * @param  msglen   The length of the partial message
  * @param  bits     The number of bits at the end of the message not covered by `msglen`
  * @param  suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
  * @param  hashsum  Output parameter for the hashsum, may be `NULL`
  */
-LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1, 2))))
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
 void libkeccak_zerocopy_digest(struct libkeccak_state *restrict, void *restrict, size_t,
                                size_t, const char *restrict, void *restrict);
 
@@ -226,15 +251,15 @@ void libkeccak_zerocopy_digest(struct libkeccak_state *restrict, void *restrict,
  * @param   bits     The number of bits at the end of the message not covered by `msglen`
  * @param   suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
  * @param   hashsum  Output parameter for the hashsum, may be `NULL`
- * @return           Zero on success, -1 on error
+ * @return           Zero
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
 int libkeccak_fast_digest(struct libkeccak_state *restrict, const void *restrict, size_t,
                           size_t, const char *restrict, void *restrict);
 
 /**
- * Absorb the last part of the message and squeeze the Keccak sponge
- * and wipe sensitive data when possible
+ * Absorb the last part of the message and squeeze the Keccak sponge,
+ * and wipe the message buffered in the state
  * 
  * @param   state    The hashing state
  * @param   msg      The rest of the message, may be `NULL`
@@ -242,7 +267,7 @@ int libkeccak_fast_digest(struct libkeccak_state *restrict, const void *restrict
  * @param   bits     The number of bits at the end of the message not covered by `msglen`
  * @param   suffix   The suffix concatenate to the message, only '1':s and '0':s, and NUL-termination
  * @param   hashsum  Output parameter for the hashsum, may be `NULL`
- * @return           Zero on success, -1 on error
+ * @return           Zero
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
 int libkeccak_digest(struct libkeccak_state *restrict, const void *restrict, size_t,
@@ -280,6 +305,77 @@ libkeccak_fast_squeeze(register struct libkeccak_state *state, register long int
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
 void libkeccak_squeeze(register struct libkeccak_state *restrict, register void *restrict);
 
+/**
+ * Calculate the hashsums of multiple messages
+ * 
+ * Messages are processed several at a time, with their sponges
+ * permuted in parallel, when the word size is at least 8 bits:
+ * four at a time for 1600-bit states, eight for 800-bit states,
+ * sixteen for 400-bit states, and thirty-two for 200-bit states
+ * 
+ * @param   spec      The specifications for the hashing algorithm
+ * @param   msgs      The messages, an element may be `NULL` if
+ *                    the corresponding element in `lens` is 0
+ * @param   lens      The length of each message, in bytes
+ * @param   suffix    The suffix concatenate to each message, only '1':s and '0':s, and NUL-termination
+ * @param   hashsums  Output parameters for the hashsums
+ * @param   n         The number of messages
+ * @return            Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_digest_many(const struct libkeccak_spec *restrict, const void *const *restrict, const size_t *restrict,
+                          const char *restrict, void *const *restrict, size_t);
+
+/**
+ * Calculate the hashsums of multiple messages, performing only
+ * the last rounds of Keccak-f, that is Keccak-p
+ * 
+ * Messages are processed several at a time, with their sponges
+ * permuted in parallel, when the word size is at least 8 bits:
+ * four at a time for 1600-bit states, eight for 800-bit states,
+ * sixteen for 400-bit states, and thirty-two for 200-bit states
+ * 
+ * @param   spec      The specifications for the hashing algorithm
+ * @param   rounds    The number of rounds, the last `rounds` of the
+ *                    12 + 2ℓ rounds of Keccak-f are performed
+ * @param   msgs      The messages, an element may be `NULL` if
+ *                    the corresponding element in `lens` is 0
+ * @param   lens      The length of each message, in bytes
+ * @param   suffix    The suffix concatenate to each message, only '1':s and '0':s, and NUL-termination
+ * @param   hashsums  Output parameters for the hashsums
+ * @param   n         The number of messages
+ * @return            Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_digest_many_rounds(const struct libkeccak_spec *restrict, long int, const void *const *restrict,
+                                 const size_t *restrict, const char *restrict, void *const *restrict, size_t);
+
+/**
+ * Absorb the last part of two messages and squeeze the
+ * Keccak sponges, and wipe sensitive data when possible
+ * 
+ * If the states have the same parameters, the blocks the
+ * messages have in common are processed in both states at
+ * once, which can be faster than two calls to `libkeccak_digest`
+ * 
+ * @param   state1    The first hashing state
+ * @param   msg1      The rest of the first message, may be `NULL`
+ * @param   msglen1   The length of the partial first message
+ * @param   bits1     The number of bits at the end of the first message not covered by `msglen1`
+ * @param   state2    The second hashing state
+ * @param   msg2      The rest of the second message, may be `NULL`
+ * @param   msglen2   The length of the partial second message
+ * @param   bits2     The number of bits at the end of the second message not covered by `msglen2`
+ * @param   suffix    The suffix concatenate to the messages, only '1':s and '0':s, and NUL-termination
+ * @param   hashsum1  Output parameter for the hashsum of the first message, may be `NULL`
+ * @param   hashsum2  Output parameter for the hashsum of the second message, may be `NULL`
+ * @return            Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1, 5))))
+int libkeccak_digest_pair(struct libkeccak_state *restrict, const void *restrict, size_t, size_t,
+                          struct libkeccak_state *restrict, const void *restrict, size_t, size_t,
+                          const char *restrict, void *restrict, void *restrict);
+
 #include "libkeccak/extra.h"
 
 /**
@@ -290,10 +386,7 @@ void libkeccak_squeeze(register struct libkeccak_state *restrict, register void
 inline void
 libkeccak_state_fast_destroy(struct libkeccak_state *state)
 {
-	if (state) {
-		free(state->M);
-		state->M = NULL;
-	}
+	(void) state;
 }
 
 /**
@@ -305,21 +398,26 @@ LIBKECCAK_GCC_ONLY(__attribute__((__optimize__("-O0"))))
 inline void
 libkeccak_state_destroy(volatile struct libkeccak_state *state)
 {
-	if (state) {
+	if (state)
 		libkeccak_state_wipe(state);
-		free(state->M);
-		state->M = NULL;
-	}
 }
 
 #include "libkeccak/util.h"
 #include "libkeccak/hmac.h"
+#include "libkeccak/jobs.h"
+#include "libkeccak/batch.h"
+#include "libkeccak/pool.h"
+#include "libkeccak/k12.h"
 
 #include "libkeccak/keccak.h"
 #include "libkeccak/sha3.h"
 #include "libkeccak/rawshake.h"
 #include "libkeccak/shake.h"
 #include "libkeccak/cshake.h"
+#include "libkeccak/turboshake.h"
+#include "libkeccak/parallelhash.h"
+#include "libkeccak/kmac.h"
+#include "libkeccak/tuplehash.h"
 
 #include "libkeccak/legacy.h"
 
@@ -0,0 +1,163 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * Internal description of the routines used for a batch of states
+ */
+struct libkeccak_multi;
+
+
+/**
+ * Data structure that describes the state of a number of
+ * hashing processes that use the same hashing specifications
+ * 
+ * The sponges are stored in blocks of `.ways` sponges, with
+ * the sponges in each block interleaved, so that one lane of
+ * every sponge in a block is stored contiguously: lane (x, y)
+ * of sponge k is stored at index
+ * `(k / .ways * 25 + x + 5y) * .ways + k % .ways`
+ */
+struct libkeccak_state_batch {
+	/**
+	 * The lanes of the sponges, use the member
+	 * for the word size
+	 */
+	union {
+		uint64_t *w64;
+		uint32_t *w32;
+		uint16_t *w16;
+		uint8_t *w8;
+	} S;
+
+	/**
+	 * The bitrate
+	 */
+	long int r;
+
+	/**
+	 * The capacity
+	 */
+	long int c;
+
+	/**
+	 * The output size
+	 */
+	long int n;
+
+	/**
+	 * The state size
+	 */
+	long int b;
+
+	/**
+	 * The word size
+	 */
+	long int w;
+
+	/**
+	 * The number of rounds
+	 */
+	long int nr;
+
+	/**
+	 * The number of sponges
+	 */
+	size_t count;
+
+	/**
+	 * The number of sponges that are permuted
+	 * together, the number of sponges allocated
+	 * is `.count` rounded up to a multiple of this
+	 */
+	size_t ways;
+
+	/**
+	 * The routines for the word size, for internal use
+	 */
+	const struct libkeccak_multi *multi;
+};
+
+
+/**
+ * Initialise a batch of states according to hashing specifications
+ * 
+ * @param   batch  The batch that should be initialised
+ * @param   spec   The specifications for the states
+ * @param   count  The number of states, must not be 0
+ * @return         Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
+int libkeccak_state_batch_initialise(struct libkeccak_state_batch *restrict, const struct libkeccak_spec *restrict, size_t);
+
+/**
+ * Reset the states in a batch
+ * 
+ * @param  batch  The batch that should be reset
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_state_batch_reset(struct libkeccak_state_batch *);
+
+/**
+ * Release resources allocation for a batch of states
+ * and wipe sensitive data
+ * 
+ * @param  batch  The batch that should be destroyed, may be `NULL`
+ */
+void libkeccak_state_batch_destroy(struct libkeccak_state_batch *);
+
+/**
+ * Absorb the same number of whole blocks into each state
+ * in a batch, the states are permuted after each block
+ * 
+ * @param  batch  The batch
+ * @param  msgs   The message to absorb into each state
+ * @param  len    The number of bytes to absorb into each
+ *                state, must be a multiple of `batch->r / 8`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_state_batch_absorb(struct libkeccak_state_batch *restrict, const void *const *restrict, size_t);
+
+/**
+ * Perform the Keccak-f permutation on each state in a batch
+ * 
+ * @param  batch  The batch
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_state_batch_permute(struct libkeccak_state_batch *);
+
+/**
+ * Squeeze `batch->n` bits out of each state in a batch, the
+ * states are permuted between blocks but not before the first
+ * block, so the first call should follow the absorption of the
+ * padded last block, and subsequent calls should be preceded
+ * by a call to `libkeccak_state_batch_permute`
+ * 
+ * @param  batch     The batch
+ * @param  hashsums  Output parameter for the hashsum of each state,
+ *                   an element may be `NULL` to discard that output
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_state_batch_squeeze(struct libkeccak_state_batch *restrict, void *const *restrict);
+
+/**
+ * Copy a state out of a batch of states
+ * 
+ * @param  batch  The batch
+ * @param  k      The index of the state in the batch
+ * @param  state  Output parameter for the state, will be
+ *                initialised with the batch's specifications
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_state_batch_extract(const struct libkeccak_state_batch *restrict, size_t, struct libkeccak_state *restrict);
+
+/**
+ * Copy a state into a batch of states
+ * 
+ * @param   batch  The batch
+ * @param   k      The index of the state in the batch
+ * @param   state  The state to copy, must have the same bitrate, capacity,
+ *                 and number of rounds as the batch and no buffered message
+ * @return         Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
+int libkeccak_state_batch_insert(struct libkeccak_state_batch *restrict, size_t, const struct libkeccak_state *restrict);
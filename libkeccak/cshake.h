@@ -51,4 +51,99 @@ void libkeccak_cshake_initialise(struct libkeccak_state *restrict,
                                  const void *, size_t, size_t, const char *);
 
 
-/* TODO add libkeccak_cshakesum_fd */
+
+/**
+ * The sponge of a cSHAKE hashing process after the
+ * initialisation blocks for a function-name string
+ * and a customisation string have been absorbed
+ * 
+ * It is created once, with `libkeccak_cshake_prefix_initialise`,
+ * and then copied into a state, with `libkeccak_cshake_prefix_load`,
+ * for each message hashed with the same strings, so that the
+ * strings are neither encoded nor absorbed again
+ */
+struct libkeccak_cshake_prefix {
+	/**
+	 * The sponge after the initialisation
+	 * blocks have been absorbed
+	 */
+	struct libkeccak_state state;
+
+	/**
+	 * The message suffix to use, as
+	 * returned by `libkeccak_cshake_suffix`
+	 */
+	const char *suffix;
+};
+
+
+/**
+ * Create a cSHAKE sponge with the initialisation blocks absorbed
+ * 
+ * @param   prefix    The sponge that should be initialised
+ * @param   spec      The specifications for the hashing algorithm
+ * @param   n_text    Function name-string
+ * @param   n_len     Byte-length of `n_text` (only whole byte)
+ * @param   n_bits    Bit-length of `n_text`, minus `n_len * 8`
+ * @param   n_suffix  Bit-string, represented by a NUL-terminated
+ *                    string of '1':s and '0's:, making up the part
+ *                    after `n_text` of the function-name bit-string;
+ *                    `NULL` is treated as the empty string
+ * @param   s_text    Customisation-string
+ * @param   s_len     Byte-length of `s_text` (only whole byte)
+ * @param   s_bits    Bit-length of `s_text`, minus `s_len * 8`
+ * @param   s_suffix  Bit-string, represented by a NUL-terminated
+ *                    string of '1':s and '0's:, making up the part
+ *                    after `s_text` of the customisation bit-string;
+ *                    `NULL` is treated as the empty string
+ * @return            Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1, 2))))
+int libkeccak_cshake_prefix_initialise(struct libkeccak_cshake_prefix *restrict, const struct libkeccak_spec *restrict,
+                                       const void *, size_t, size_t, const char *,
+                                       const void *, size_t, size_t, const char *);
+
+/**
+ * Initialise a state for cSHAKE hashing by copying
+ * a sponge with the initialisation blocks absorbed
+ * 
+ * @param  state   The state that should be initialised, it
+ *                 need not be destroyed before it is reused
+ * @param  prefix  The sponge with the initialisation blocks absorbed
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_cshake_prefix_load(struct libkeccak_state *restrict, const struct libkeccak_cshake_prefix *restrict);
+
+/**
+ * Wipe a cSHAKE sponge with the initialisation blocks absorbed
+ * 
+ * @param  prefix  The sponge that should be destroyed, may be `NULL`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__artificial__)))
+inline void
+libkeccak_cshake_prefix_destroy(struct libkeccak_cshake_prefix *prefix)
+{
+	if (prefix)
+		libkeccak_state_destroy(&prefix->state);
+}
+
+/**
+ * Calculate the cSHAKE hashsum of a file,
+ * the content of the file is assumed non-sensitive
+ * 
+ * @param   fd       The file descriptor of the file to hash
+ * @param   state    The hashing state, should not be initialised (memory leak otherwise)
+ * @param   prefix   The sponge with the initialisation blocks absorbed,
+ *                   it also specifies the output size
+ * @param   hashsum  Output array for the hashsum, have an allocation size of
+ *                   at least `((prefix->state.n + 7) / 8) * sizeof(char)`, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(2, 3), __artificial__)))
+inline int
+libkeccak_cshakesum_fd(int fd, struct libkeccak_state *restrict state,
+                       const struct libkeccak_cshake_prefix *restrict prefix, void *restrict hashsum)
+{
+	libkeccak_cshake_prefix_load(state, prefix);
+	return libkeccak_generalised_sum_fd(fd, state, NULL, prefix->suffix, hashsum);
+}
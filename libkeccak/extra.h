@@ -62,11 +62,7 @@ struct libkeccak_state *libkeccak_state_create(const struct libkeccak_spec *);
 inline void
 libkeccak_state_fast_free(struct libkeccak_state *state)
 {
-	if (state) {
-		free(state->M);
-		state->M = NULL;
-		free(state);
-	}
+	free(state);
 }
 
 
@@ -86,8 +82,6 @@ libkeccak_state_free(volatile struct libkeccak_state *state)
 #endif
 	if (state) {
 		libkeccak_state_wipe(state);
-		free(state->M);
-		state->M = NULL;
 		free((struct libkeccak_state *)state);
 	}
 #ifdef __GNUC__
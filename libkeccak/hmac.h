@@ -13,18 +13,6 @@
  * Data structure that describes the state of an HMAC-hashing process
  */
 struct libkeccak_hmac_state {
-	/**
-	 * The key right-padded and XOR:ed with the outer pad
-	 */
-	unsigned char *restrict key_opad;
-
-	/**
-	 * The key right-padded and XOR:ed with the inner pad
-	 */
-	unsigned char *restrict key_ipad;
-	/* Not marshalled, implicitly unmarshalled using `key_opad`. */
-	/* Shares allocation with `key_opad`, do not `free`. */
-
 	/**
 	 * The length of key, but at least the input block size, in bits
 	 */
@@ -36,27 +24,47 @@ struct libkeccak_hmac_state {
 	struct libkeccak_state sponge;
 
 	/**
-	 * Buffer used to temporarily store bit shift message if
-	 * `.key_length` is not zero modulus 8
+	 * The state of the underlaying hash-algorithm after
+	 * the key XOR:ed with the inner pad has been absorbed,
+	 * `.sponge` is copied from it for each message
 	 */
-	unsigned char *restrict buffer;
+	struct libkeccak_state inner;
 
 	/**
-	 * The allocation size of `.buffer`
+	 * The state of the underlaying hash-algorithm after
+	 * the key XOR:ed with the outer pad has been absorbed,
+	 * `.sponge` is copied from it for the outer hashing
 	 */
-	size_t buffer_size;
+	struct libkeccak_state outer;
 
 	/**
 	 * Part of feed key, message or digest that have not been passed yet
 	 */
 	unsigned char leftover;
 
-	char _pad[sizeof(void *) - 1];
+	/**
+	 * The value `.leftover` shall have when `.sponge`
+	 * is copied from `.inner`
+	 */
+	unsigned char inner_leftover;
+
+	/**
+	 * The value `.leftover` shall have when `.sponge`
+	 * is copied from `.outer`
+	 */
+	unsigned char outer_leftover;
+
+	char _pad[sizeof(void *) - 3];
 };
 
 
 /**
- * Change the HMAC-hashing key on the state
+ * Change the HMAC-hashing key on the state, and
+ * start hashing a new message with the new key
+ * 
+ * The key is absorbed into `state->inner` and
+ * `state->outer` which are then reused for
+ * each message until the key is changed
  * 
  * @param   state       The state that should be reset
  * @param   key         The new key
@@ -87,9 +95,6 @@ libkeccak_hmac_initialise(struct libkeccak_hmac_state *restrict state, const str
 		libkeccak_state_destroy(&state->sponge);
 		return -1;
 	}
-	state->leftover = 0;
-	state->buffer = NULL;
-	state->buffer_size = 0;
 	return 0;
 }
 
@@ -125,12 +130,7 @@ libkeccak_hmac_create(const struct libkeccak_spec *restrict spec, const void *re
  * @return              Zero on success, -1 on error
  */
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
-inline int
-libkeccak_hmac_reset(struct libkeccak_hmac_state *restrict state, const void *restrict key, size_t key_length)
-{
-	libkeccak_state_reset(&state->sponge);
-	return key ? libkeccak_hmac_set_key(state, key, key_length) : 0;
-}
+int libkeccak_hmac_reset(struct libkeccak_hmac_state *restrict, const void *restrict, size_t);
 
 
 /**
@@ -152,13 +152,7 @@ libkeccak_hmac_fast_destroy(struct libkeccak_hmac_state *state)
 {
 	if (!state)
 		return;
-	free(state->key_opad);
-	state->key_opad = NULL;
-	state->key_ipad = NULL;
 	state->key_length = 0;
-	free(state->buffer);
-	state->buffer = NULL;
-	state->buffer_size = 0;
 }
 
 
@@ -174,14 +168,7 @@ libkeccak_hmac_destroy(volatile struct libkeccak_hmac_state *state)
 	if (!state)
 		return;
 	libkeccak_hmac_wipe(state);
-	free(state->key_opad);
-	state->key_opad = NULL;
-	state->key_ipad = NULL;
 	state->key_length = 0;
-	state->leftover = 0;
-	free(state->buffer);
-	state->buffer = NULL;
-	state->buffer_size = 0;
 }
 
 
@@ -273,12 +260,16 @@ libkeccak_hmac_marshal(const struct libkeccak_hmac_state *restrict state, void *
 # pragma clang diagnostic pop
 #endif
 		data += sizeof(size_t);
-		memcpy(data, state->key_opad, (state->key_length + 7) >> 3);
-		data += (state->key_length + 7) >> 3;
-		data[0] = (unsigned char)!!state->key_ipad;
-		data[1] = state->leftover;
+		data += libkeccak_state_marshal(&state->inner, data);
+		data += libkeccak_state_marshal(&state->outer, data);
+		data[0] = state->leftover;
+		data[1] = state->inner_leftover;
+		data[2] = state->outer_leftover;
 	}
-	return written + sizeof(size_t) + ((state->key_length + 7) >> 3) + 2 * sizeof(char);
+	written += sizeof(size_t);
+	written += libkeccak_state_marshal(&state->inner, NULL);
+	written += libkeccak_state_marshal(&state->outer, NULL);
+	return written + 3 * sizeof(char);
 }
 
 
@@ -356,3 +347,31 @@ int libkeccak_hmac_fast_digest(struct libkeccak_hmac_state *restrict state, cons
 LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
 int libkeccak_hmac_digest(struct libkeccak_hmac_state *restrict state, const void *restrict msg, size_t msglen,
                           size_t bits, const char *restrict suffix, void *restrict hashsum);
+
+
+/**
+ * Absorb the last part of two messages and fetch their
+ * hashes, and wipe sensitive data when possible
+ * 
+ * If the states have the same parameters and byte-aligned
+ * keys, the two messages are hashed together, which can be
+ * faster than two calls to `libkeccak_hmac_digest`
+ * 
+ * @param   state1    The first hashing state
+ * @param   msg1      The rest of the first message, may be `NULL`, may be modified
+ * @param   msglen1   The length of the partial first message
+ * @param   bits1     The number of bits at the end of the first message not covered by `msglen1`
+ * @param   state2    The second hashing state
+ * @param   msg2      The rest of the second message, may be `NULL`, may be modified
+ * @param   msglen2   The length of the partial second message
+ * @param   bits2     The number of bits at the end of the second message not covered by `msglen2`
+ * @param   suffix    The suffix concatenate to the messages, only '1':s and '0':s, and NUL-termination
+ * @param   hashsum1  Output parameter for the hashsum of the first message, may be `NULL`
+ * @param   hashsum2  Output parameter for the hashsum of the second message, may be `NULL`
+ * @return            Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1, 5))))
+int libkeccak_hmac_digest_pair(struct libkeccak_hmac_state *restrict state1, const void *restrict msg1, size_t msglen1,
+                               size_t bits1, struct libkeccak_hmac_state *restrict state2, const void *restrict msg2,
+                               size_t msglen2, size_t bits2, const char *restrict suffix, void *restrict hashsum1,
+                               void *restrict hashsum2);
@@ -0,0 +1,107 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * A message to hash with a job manager
+ */
+struct libkeccak_job {
+	/**
+	 * The specifications for the hashing algorithm
+	 */
+	const struct libkeccak_spec *spec;
+
+	/**
+	 * The message, may be `NULL` if `.msglen` is 0,
+	 * it is not copied and must be kept until the
+	 * job is returned as completed
+	 */
+	const void *msg;
+
+	/**
+	 * The length of the message, in bytes
+	 */
+	size_t msglen;
+
+	/**
+	 * The suffix concatenate to the message, only '1':s
+	 * and '0':s, and NUL-termination, may be `NULL`
+	 */
+	const char *suffix;
+
+	/**
+	 * Output parameter for the hashsum, must have an
+	 * allocation size of at least `((.spec->output + 7) / 8)`
+	 */
+	void *hashsum;
+
+	/**
+	 * Not used by libkeccak, available to the application
+	 * to identify the job when it is returned
+	 */
+	void *user_data;
+
+	/**
+	 * The next completed job, for internal use
+	 */
+	struct libkeccak_job *next;
+};
+
+
+/**
+ * Multi-buffer job manager, for internal use
+ */
+struct libkeccak_job_manager;
+
+
+/**
+ * Create a job manager
+ * 
+ * @return  The job manager, `NULL` on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__warn_unused_result__, __malloc__)))
+struct libkeccak_job_manager *libkeccak_job_manager_create(void);
+
+/**
+ * Wipe sensitive data and deallocate a job manager,
+ * jobs that have not been completed are abandoned
+ * 
+ * @param  manager  The job manager, may be `NULL`
+ */
+void libkeccak_job_manager_free(struct libkeccak_job_manager *);
+
+/**
+ * Submit a job to a job manager
+ * 
+ * Jobs whose sponges can be permuted in parallel are processed
+ * together; if all lanes for the job's algorithm are filled,
+ * the sponges are processed until at least one job completes
+ * 
+ * @param   manager  The job manager
+ * @param   job      The job, must not be modified until it is
+ *                   returned by `libkeccak_job_manager_get_completed`
+ *                   or `libkeccak_job_manager_flush`
+ * @return           Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
+int libkeccak_job_manager_submit(struct libkeccak_job_manager *restrict, struct libkeccak_job *restrict);
+
+/**
+ * Get a completed job, without processing any submitted jobs
+ * 
+ * @param   manager  The job manager
+ * @return           A completed job, `NULL` if none is available
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+struct libkeccak_job *libkeccak_job_manager_get_completed(struct libkeccak_job_manager *);
+
+/**
+ * Get a completed job, and if none is available, process
+ * submitted jobs, with the lanes that are not filled left
+ * idle, until at least one job completes
+ * 
+ * @param   manager  The job manager
+ * @return           A completed job, `NULL` if there are
+ *                   no submitted jobs left
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+struct libkeccak_job *libkeccak_job_manager_flush(struct libkeccak_job_manager *);
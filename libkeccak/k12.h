@@ -0,0 +1,140 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * The size of the chunks a message is split into
+ * by KangarooTwelve, in bytes
+ */
+#define LIBKECCAK_K12_CHUNK_SIZE 8192
+
+
+/**
+ * Data structure that describes the state of
+ * a KangarooTwelve (KT128 or KT256) hashing process
+ * 
+ * The first chunk of the message is absorbed directly into
+ * the final node; the following chunks are collected until
+ * enough of them are available to hash them as leaves in
+ * parallel, with the multi-buffer kernels and the threads
+ * of the worker pool, and their chaining values are then
+ * absorbed into the final node
+ */
+struct libkeccak_k12_state {
+	/**
+	 * The sponge of the final node, after `libkeccak_k12_digest`
+	 * it can be used with `libkeccak_squeeze` to get more output
+	 */
+	struct libkeccak_state final;
+
+	/**
+	 * The chunks that have not been hashed yet,
+	 * allocated when the first chunk is completed
+	 */
+	unsigned char *buffer;
+
+	/**
+	 * Output buffer for the chaining values of the leaves
+	 */
+	unsigned char *cvs;
+
+	/**
+	 * The number of bytes in `.buffer`
+	 */
+	size_t buffered;
+
+	/**
+	 * The number of chunks `.buffer` can hold
+	 */
+	size_t capacity;
+
+	/**
+	 * The number of bytes of the first chunk that have
+	 * been absorbed, at most `LIBKECCAK_K12_CHUNK_SIZE`
+	 */
+	size_t first;
+
+	/**
+	 * The number of leaves whose chaining
+	 * values have been absorbed
+	 */
+	size_t leaves;
+
+	/**
+	 * The value of x in `KTx`, 128 or 256
+	 */
+	long int semicapacity;
+
+	/**
+	 * The worker pool used to hash the leaves, may be `NULL`
+	 */
+	struct libkeccak_worker_pool *pool;
+};
+
+
+/**
+ * Initialise a KangarooTwelve hashing state
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `KTx`, 128 for KT128
+ *                        (KangarooTwelve) or 256 for KT256
+ * @param   output        The output size, in bits
+ * @param   pool          Worker pool used to hash the leaves,
+ *                        `NULL` to use only the calling thread
+ * @return                Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_k12_initialise(struct libkeccak_k12_state *restrict, long int, long int, struct libkeccak_worker_pool *);
+
+/**
+ * Release resources allocation for a KangarooTwelve
+ * hashing state and wipe sensitive data
+ * 
+ * @param  state  The state that should be destroyed, may be `NULL`
+ */
+void libkeccak_k12_destroy(struct libkeccak_k12_state *);
+
+/**
+ * Absorb more of the message to a KangarooTwelve hashing state
+ * 
+ * @param   state   The hashing state
+ * @param   msg     The partial message
+ * @param   msglen  The length of the partial message, in bytes
+ * @return          Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_k12_update(struct libkeccak_k12_state *restrict, const void *restrict, size_t);
+
+/**
+ * Absorb the last part of the message and the customisation
+ * string, and squeeze the KangarooTwelve hashing state
+ * 
+ * @param   state      The hashing state
+ * @param   msg        The rest of the message, may be `NULL`
+ * @param   msglen     The length of the partial message, in bytes
+ * @param   custom     The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen  The length of the customisation string, in bytes
+ * @param   hashsum    Output parameter for the hashsum, may be `NULL`
+ * @return             Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_k12_digest(struct libkeccak_k12_state *restrict, const void *restrict, size_t,
+                         const void *restrict, size_t, void *restrict);
+
+/**
+ * Calculate the KangarooTwelve hashsum of a file,
+ * the content of the file is assumed non-sensitive
+ * 
+ * @param   fd            The file descriptor of the file to hash
+ * @param   state         The hashing state, should not be initialised (memory leak otherwise)
+ * @param   semicapacity  The value of x in `KTx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   pool          Worker pool used to hash the leaves, may be `NULL`
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @param   hashsum       Output array for the hashsum, have an allocation size of
+ *                        at least `((output + 7) / 8) * sizeof(char)`, may be `NULL`
+ * @return                Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(2))))
+int libkeccak_k12sum_fd(int, struct libkeccak_k12_state *restrict, long int, long int, struct libkeccak_worker_pool *,
+                        const void *restrict, size_t, void *restrict);
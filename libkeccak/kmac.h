@@ -0,0 +1,101 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * Data structure that describes the state of a
+ * KMAC (KMAC128 or KMAC256, or the XOF variants)
+ * hashing process
+ * 
+ * The customisation string and the key are absorbed
+ * once, into `.keyed`, and each message is then hashed
+ * in `.sponge`, starting from a copy of `.keyed`
+ */
+struct libkeccak_kmac_state {
+	/**
+	 * The sponge after the customisation string
+	 * and the key have been absorbed
+	 */
+	struct libkeccak_state keyed;
+
+	/**
+	 * The sponge of the current message, after
+	 * `libkeccak_kmac_digest` it can be used
+	 * with `libkeccak_squeeze` to get more output
+	 */
+	struct libkeccak_state sponge;
+};
+
+
+/**
+ * Initialise a KMAC hashing state and absorb the key
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `KMACx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   key           The key, may be `NULL` if `keylen` is 0
+ * @param   keylen        The length of the key, in bytes
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @return                Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_kmac_initialise(struct libkeccak_kmac_state *restrict, long int, long int,
+                              const void *restrict, size_t, const void *restrict, size_t);
+
+/**
+ * Reset a KMAC hashing state so that a new
+ * message can be hashed with the same key
+ * 
+ * This only copies the sponge, the key
+ * is not absorbed again
+ * 
+ * @param  state  The hashing state
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__)))
+void libkeccak_kmac_reset(struct libkeccak_kmac_state *);
+
+/**
+ * Absorb more of the message to a KMAC hashing state
+ * 
+ * @param   state   The hashing state
+ * @param   msg     The partial message
+ * @param   msglen  The length of the partial message, in bytes
+ * @return          Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1), __artificial__)))
+inline int
+libkeccak_kmac_update(struct libkeccak_kmac_state *restrict state, const void *restrict msg, size_t msglen)
+{
+	return libkeccak_update(&state->sponge, msg, msglen);
+}
+
+/**
+ * Absorb the last part of the message and squeeze
+ * the KMAC hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   msg      The rest of the message, may be `NULL`
+ * @param   msglen   The length of the partial message, in bytes
+ * @param   xof      Non-zero for KMACXOF, where the output
+ *                   does not depend on the output size
+ * @param   hashsum  Output parameter for the hashsum, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_kmac_digest(struct libkeccak_kmac_state *restrict, const void *restrict, size_t, int, void *restrict);
+
+/**
+ * Wipe sensitive data in a KMAC hashing state,
+ * including the absorbed key
+ * 
+ * @param  state  The state that should be destroyed, may be `NULL`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__artificial__)))
+inline void
+libkeccak_kmac_destroy(struct libkeccak_kmac_state *state)
+{
+	if (state) {
+		libkeccak_state_destroy(&state->keyed);
+		libkeccak_state_destroy(&state->sponge);
+	}
+}
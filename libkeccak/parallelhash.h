@@ -0,0 +1,134 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * Data structure that describes the state of a
+ * ParallelHash (ParallelHash128 or ParallelHash256,
+ * or the XOF variants) hashing process
+ * 
+ * The message is collected until enough blocks are
+ * available to hash them in parallel, with the
+ * multi-buffer kernels and the threads of the worker
+ * pool, and their chaining values are then absorbed,
+ * in order, into the final node
+ * 
+ * Blocks too large to be collected are instead
+ * absorbed into `.leaf` as the message arrives,
+ * except for whole blocks in the same update,
+ * which are hashed in parallel directly from
+ * the message
+ * 
+ * No memory is allocated until the first
+ * non-empty part of the message is absorbed
+ */
+struct libkeccak_parallelhash_state {
+	/**
+	 * The sponge of the final node, after `libkeccak_parallelhash_digest`
+	 * it can be used with `libkeccak_squeeze` to get more output
+	 */
+	struct libkeccak_state final;
+
+	/**
+	 * The sponge of the current block when
+	 * blocks are too large to be collected
+	 */
+	struct libkeccak_state leaf;
+
+	/**
+	 * The blocks that have not been hashed yet,
+	 * `NULL` if not allocated or if blocks are
+	 * absorbed into `.leaf`
+	 */
+	unsigned char *buffer;
+
+	/**
+	 * Output buffer for the chaining values of the blocks,
+	 * `NULL` if not allocated
+	 */
+	unsigned char *cvs;
+
+	/**
+	 * The block size, B, in bytes
+	 */
+	size_t blocksize;
+
+	/**
+	 * The number of bytes in `.buffer`, or of
+	 * the current block absorbed into `.leaf`
+	 */
+	size_t buffered;
+
+	/**
+	 * The number of blocks `.buffer` can hold
+	 */
+	size_t capacity;
+
+	/**
+	 * The number of blocks whose chaining
+	 * values have been absorbed
+	 */
+	size_t blocks;
+
+	/**
+	 * The value of x in `ParallelHashx`, 128 or 256
+	 */
+	long int semicapacity;
+
+	/**
+	 * The worker pool used to hash the blocks, may be `NULL`
+	 */
+	struct libkeccak_worker_pool *pool;
+};
+
+
+/**
+ * Initialise a ParallelHash hashing state
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `ParallelHashx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   blocksize     The block size, B, in bytes, must not be 0
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @param   pool          Worker pool used to hash the blocks,
+ *                        `NULL` to use only the calling thread
+ * @return                Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_parallelhash_initialise(struct libkeccak_parallelhash_state *restrict, long int, long int, size_t,
+                                      const void *restrict, size_t, struct libkeccak_worker_pool *);
+
+/**
+ * Release resources allocation for a ParallelHash
+ * hashing state and wipe sensitive data
+ * 
+ * @param  state  The state that should be destroyed, may be `NULL`
+ */
+void libkeccak_parallelhash_destroy(struct libkeccak_parallelhash_state *);
+
+/**
+ * Absorb more of the message to a ParallelHash hashing state
+ * 
+ * @param   state   The hashing state
+ * @param   msg     The partial message
+ * @param   msglen  The length of the partial message, in bytes
+ * @return          Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_parallelhash_update(struct libkeccak_parallelhash_state *restrict, const void *restrict, size_t);
+
+/**
+ * Absorb the last part of the message and squeeze
+ * the ParallelHash hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   msg      The rest of the message, may be `NULL`
+ * @param   msglen   The length of the partial message, in bytes
+ * @param   xof      Non-zero for ParallelHashXOF, where the output
+ *                   does not depend on the output size
+ * @param   hashsum  Output parameter for the hashsum, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_parallelhash_digest(struct libkeccak_parallelhash_state *restrict, const void *restrict, size_t,
+                                  int, void *restrict);
@@ -0,0 +1,28 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * Pool of threads that hash independent parts of
+ * a message in parallel, for internal use
+ */
+struct libkeccak_worker_pool;
+
+
+/**
+ * Create a worker pool
+ * 
+ * @param   threads  The number of threads that shall work on a message,
+ *                   including the thread that is hashing the message;
+ *                   0 for the number of online CPUs
+ * @return           The worker pool, `NULL` on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__warn_unused_result__, __malloc__)))
+struct libkeccak_worker_pool *libkeccak_worker_pool_create(size_t);
+
+/**
+ * Stop the threads in a worker pool and deallocate it,
+ * the pool must not be in use
+ * 
+ * @param  pool  The worker pool, may be `NULL`
+ */
+void libkeccak_worker_pool_free(struct libkeccak_worker_pool *);
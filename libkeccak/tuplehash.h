@@ -0,0 +1,65 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * A field of a tuple to hash with TupleHash
+ */
+struct libkeccak_tuple_field {
+	/**
+	 * The content of the field, may be
+	 * `NULL` if `.len` is 0
+	 */
+	const void *data;
+
+	/**
+	 * The length of the field, in bytes
+	 */
+	size_t len;
+};
+
+
+/**
+ * Initialise a state for TupleHash (TupleHash128 or
+ * TupleHash256, or the XOF variants) hashing
+ * 
+ * The tuple is hashed with `libkeccak_tuplehash_update`
+ * and `libkeccak_tuplehash_digest`, which absorb each
+ * field's encoded length and its content directly,
+ * without concatenating them into a buffer first
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `TupleHashx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @return                Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_tuplehash_initialise(struct libkeccak_state *restrict, long int, long int, const void *restrict, size_t);
+
+/**
+ * Absorb fields of a tuple to a TupleHash hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   fields   The fields, may be `NULL` if `nfields` is 0
+ * @param   nfields  The number of elements in `fields`
+ * @return           Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_tuplehash_update(struct libkeccak_state *restrict, const struct libkeccak_tuple_field *restrict, size_t);
+
+/**
+ * Absorb the last fields of a tuple and
+ * squeeze the TupleHash hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   fields   The fields, may be `NULL` if `nfields` is 0
+ * @param   nfields  The number of elements in `fields`
+ * @param   xof      Non-zero for TupleHashXOF, where the output
+ *                   does not depend on the output size
+ * @param   hashsum  Output parameter for the hashsum, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(1))))
+int libkeccak_tuplehash_digest(struct libkeccak_state *restrict, const struct libkeccak_tuple_field *restrict, size_t,
+                               int, void *restrict);
@@ -0,0 +1,83 @@
+/* See LICENSE file for copyright and license details. */
+
+
+/**
+ * Message suffix for TurboSHAKE hashing with the
+ * default domain separation byte, 0x1F
+ */
+#define LIBKECCAK_TURBOSHAKE_SUFFIX "1111"
+
+
+/**
+ * The number of rounds of Keccak-p[1600] used by TurboSHAKE
+ * and the leaves of KangarooTwelve; TurboSHAKEx has the same
+ * bitrate and capacity as SHAKEx, see `libkeccak_spec_shake`
+ */
+#define LIBKECCAK_TURBOSHAKE_ROUNDS 12
+
+
+/**
+ * Initialise a state for TurboSHAKEx hashing, which
+ * uses the last 12 rounds of Keccak-f[1600]
+ * 
+ * @param   state  The state that should be initialised
+ * @param   x      The value of x in `TurboSHAKEx`, half the capacity
+ * @param   d      The output size
+ * @return         Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__)))
+inline int
+libkeccak_turboshake_initialise(struct libkeccak_state *state, long int x, long int d)
+{
+	struct libkeccak_spec spec;
+	libkeccak_spec_shake(&spec, x, d);
+	return libkeccak_state_initialise_rounds(state, &spec, LIBKECCAK_TURBOSHAKE_ROUNDS);
+}
+
+
+/**
+ * Get message suffix for TurboSHAKE hashing with
+ * a specific domain separation byte
+ * 
+ * The bits of the domain separation byte below its most
+ * significant set bit make up the suffix, the most significant
+ * set bit is the first bit of the pad10*1 padding
+ * 
+ * @param   d    The domain separation byte, 0x01 to 0x7F
+ * @param   buf  Output buffer for the suffix, must have an
+ *               allocation size of at least 8 bytes
+ * @return       `buf`
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__, __nothrow__, __returns_nonnull__)))
+inline const char *
+libkeccak_turboshake_suffix(int d, char *buf)
+{
+	char *p = buf;
+	for (; d > 1; d >>= 1)
+		*p++ = (char)('0' + (d & 1));
+	*p = '\0';
+	return buf;
+}
+
+
+/**
+ * Calculate the TurboSHAKE hashsum of a file, with the
+ * default domain separation byte, 0x1F, the content
+ * of the file is assumed non-sensitive
+ * 
+ * @param   fd            The file descriptor of the file to hash
+ * @param   state         The hashing state, should not be initialised (memory leak otherwise)
+ * @param   semicapacity  The semicapacity parameter for the hashing algorithm
+ * @param   output        The output size parameter for the hashing algorithm
+ * @param   hashsum       Output array for the hashsum, have an allocation size of
+ *                        at least `((output + 7) / 8) * sizeof(char)`, may be `NULL`
+ * @return                Zero on success, -1 on error
+ */
+LIBKECCAK_GCC_ONLY(__attribute__((__nonnull__(2), __artificial__)))
+inline int
+libkeccak_turboshakesum_fd(int fd, struct libkeccak_state *restrict state, long semicapacity, long output, void *restrict hashsum)
+{
+	if (libkeccak_turboshake_initialise(state, semicapacity, output) < 0)
+		return -1;
+	return libkeccak_generalised_sum_fd(fd, state, NULL, LIBKECCAK_TURBOSHAKE_SUFFIX, hashsum);
+}
@@ -0,0 +1,5 @@
+/* See LICENSE file for copyright and license details. */
+#include "common.h"
+
+
+extern inline void libkeccak_cshake_prefix_destroy(struct libkeccak_cshake_prefix *);
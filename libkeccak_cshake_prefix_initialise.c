@@ -0,0 +1,45 @@
+/* See LICENSE file for copyright and license details. */
+#include "common.h"
+
+
+/**
+ * Create a cSHAKE sponge with the initialisation blocks absorbed
+ * 
+ * @param   prefix    The sponge that should be initialised
+ * @param   spec      The specifications for the hashing algorithm
+ * @param   n_text    Function name-string
+ * @param   n_len     Byte-length of `n_text` (only whole byte)
+ * @param   n_bits    Bit-length of `n_text`, minus `n_len * 8`
+ * @param   n_suffix  Bit-string, represented by a NUL-terminated
+ *                    string of '1':s and '0's:, making up the part
+ *                    after `n_text` of the function-name bit-string;
+ *                    `NULL` is treated as the empty string
+ * @param   s_text    Customisation-string
+ * @param   s_len     Byte-length of `s_text` (only whole byte)
+ * @param   s_bits    Bit-length of `s_text`, minus `s_len * 8`
+ * @param   s_suffix  Bit-string, represented by a NUL-terminated
+ *                    string of '1':s and '0's:, making up the part
+ *                    after `s_text` of the customisation bit-string;
+ *                    `NULL` is treated as the empty string
+ * @return            Zero on success, -1 on error
+ */
+int
+libkeccak_cshake_prefix_initialise(struct libkeccak_cshake_prefix *restrict prefix, const struct libkeccak_spec *restrict spec,
+                                   const void *n_text, size_t n_len, size_t n_bits, const char *n_suffix,
+                                   const void *s_text, size_t s_len, size_t s_bits, const char *s_suffix)
+{
+	size_t nlen, slen;
+
+	if (libkeccak_state_initialise(&prefix->state, spec) < 0)
+		return -1;
+
+	libkeccak_cshake_initialise(&prefix->state, n_text, n_len, n_bits, n_suffix, s_text, s_len, s_bits, s_suffix);
+
+	nlen = n_len + n_bits + (n_suffix ? strlen(n_suffix) : 0);
+	slen = s_len + s_bits + (s_suffix ? strlen(s_suffix) : 0);
+	prefix->suffix = libkeccak_cshake_suffix(nlen, slen);
+
+	/* Only the sponge is used, the message buffer is empty */
+	libkeccak_state_wipe_message(&prefix->state);
+	return 0;
+}
@@ -0,0 +1,17 @@
+/* See LICENSE file for copyright and license details. */
+#include "common.h"
+
+
+/**
+ * Initialise a state for cSHAKE hashing by copying
+ * a sponge with the initialisation blocks absorbed
+ * 
+ * @param  state   The state that should be initialised, it
+ *                 need not be destroyed before it is reused
+ * @param  prefix  The sponge with the initialisation blocks absorbed
+ */
+void
+libkeccak_cshake_prefix_load(struct libkeccak_state *restrict state, const struct libkeccak_cshake_prefix *restrict prefix)
+{
+	libkeccak_state_copy_unbuffered(state, &prefix->state);
+}
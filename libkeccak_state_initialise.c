@@ -14,6 +14,11 @@ libkeccak_state_initialise(struct libkeccak_state *restrict state, const struct
 {
 	long int x;
 
+	if (libkeccak_spec_check(spec)) {
+		errno = EINVAL;
+		return -1;
+	}
+
 	state->r = spec->bitrate;
 	state->n = spec->output;
 	state->c = spec->capacity;
@@ -35,11 +40,11 @@ libkeccak_state_initialise(struct libkeccak_state *restrict state, const struct
 
 	state->nr = 12 + (state->l << 1);
 	state->wmod = (state->w == 64) ? ~0ULL : (uint64_t)((1ULL << state->w) - 1);
+	state->kernels = libkeccak_get_kernels(state->w);
 	for (x = 0; x < 25; x++)
 		state->S.w64[x] = 0;
 	state->mptr = 0;
-	state->mlen = (size_t)(state->r * state->b) >> 2;
+	state->mlen = sizeof(state->M);
 
-	state->M = malloc(state->mlen * sizeof(char));
-	return state->M == NULL ? -1 : 0;
+	return 0;
 }
@@ -0,0 +1,27 @@
+/* See LICENSE file for copyright and license details. */
+#include "common.h"
+
+
+/**
+ * Initialise a state according to hashing specifications,
+ * performing only the last rounds of Keccak-f, that is Keccak-p
+ * 
+ * @param   state   The state that should be initialised
+ * @param   spec    The specifications for the state
+ * @param   rounds  The number of rounds, the last `rounds` of the
+ *                  12 + 2ℓ rounds of Keccak-f are performed
+ * @return          Zero on success, -1 on error
+ */
+int
+libkeccak_state_initialise_rounds(struct libkeccak_state *restrict state, const struct libkeccak_spec *restrict spec,
+                                  long int rounds)
+{
+	if (libkeccak_state_initialise(state, spec) < 0)
+		return -1;
+	if (rounds <= 0 || rounds > state->nr) {
+		errno = EINVAL;
+		return -1;
+	}
+	state->nr = rounds;
+	return 0;
+}
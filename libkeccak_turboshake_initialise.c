@@ -0,0 +1,5 @@
+/* See LICENSE file for copyright and license details. */
+#include "common.h"
+
+
+extern inline int libkeccak_turboshake_initialise(struct libkeccak_state *, long int, long int);
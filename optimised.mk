@@ -12,4 +12,4 @@ CC = c99
 
 CFLAGS   = -Wall -Wextra $(CCOPTIMISE)
 CPPFLAGS = -D_DEFAULT_SOURCE -D_BSD_SOURCE -D_XOPEN_SOURCE=700
-LDFLAGS  = $(LDOPTIMISE)
+LDFLAGS  = $(LDOPTIMISE) -lpthread
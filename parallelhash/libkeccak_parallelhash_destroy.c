@@ -0,0 +1,29 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Release resources allocation for a ParallelHash
+ * hashing state and wipe sensitive data
+ * 
+ * @param  state  The state that should be destroyed, may be `NULL`
+ */
+void
+libkeccak_parallelhash_destroy(struct libkeccak_parallelhash_state *state)
+{
+	if (!state)
+		return;
+	if (state->buffer) {
+		my_explicit_bzero(state->buffer, state->capacity * state->blocksize);
+		free(state->buffer);
+		state->buffer = NULL;
+	}
+	if (state->cvs) {
+		my_explicit_bzero(state->cvs, state->capacity * (size_t)state->semicapacity / 4);
+		free(state->cvs);
+		state->cvs = NULL;
+	}
+	libkeccak_state_destroy(&state->leaf);
+	libkeccak_state_destroy(&state->final);
+}
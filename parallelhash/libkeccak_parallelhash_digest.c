@@ -0,0 +1,56 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#define NEED_RIGHT_ENCODE 1
+#include "../common.h"
+
+
+/**
+ * Absorb the last part of the message and squeeze
+ * the ParallelHash hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   msg      The rest of the message, may be `NULL`
+ * @param   msglen   The length of the partial message, in bytes
+ * @param   xof      Non-zero for ParallelHashXOF, where the output
+ *                   does not depend on the output size
+ * @param   hashsum  Output parameter for the hashsum, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+int
+libkeccak_parallelhash_digest(struct libkeccak_parallelhash_state *restrict state, const void *restrict msg, size_t msglen,
+                              int xof, void *restrict hashsum)
+{
+	unsigned char encoded[2 * (sizeof(uintmax_t) + 1)];
+	size_t n;
+	int r;
+
+	if (libkeccak_parallelhash_update(state, msg, msglen) < 0)
+		return -1;
+	if (state->buffered) {
+		if (state->buffer)
+			r = libkeccak_parallelhash_hash_blocks(state, state->buffer, state->buffered);
+		else
+			r = libkeccak_parallelhash_finish_block(state);
+		if (r < 0)
+			return -1;
+		state->buffered = 0;
+	}
+
+	n = right_encode(encoded, state->blocks);
+	n += right_encode(&encoded[n], xof ? 0 : (uintmax_t)state->final.n);
+	r = libkeccak_digest(&state->final, encoded, n, 0,
+	                     libkeccak_cshake_suffix(sizeof(PARALLELHASH_FUNCTION_NAME) - 1, 0), hashsum);
+
+	if (state->buffer) {
+		my_explicit_bzero(state->buffer, state->capacity * state->blocksize);
+		free(state->buffer);
+		state->buffer = NULL;
+	}
+	if (state->cvs) {
+		my_explicit_bzero(state->cvs, state->capacity * (size_t)state->semicapacity / 4);
+		free(state->cvs);
+		state->cvs = NULL;
+	}
+	libkeccak_state_wipe(&state->leaf);
+	return r;
+}
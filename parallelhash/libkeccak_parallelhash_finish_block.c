@@ -0,0 +1,31 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_EXPLICIT_BZERO 1
+#include "../common.h"
+
+
+/**
+ * Squeeze the chaining value of the block in the
+ * `.leaf` of a ParallelHash hashing state and
+ * absorb it into the final node
+ * 
+ * @param   state  The hashing state
+ * @return         Zero on success, -1 on error
+ */
+int
+libkeccak_parallelhash_finish_block(struct libkeccak_parallelhash_state *state)
+{
+	unsigned char cv[64];
+	size_t cvlen = (size_t)state->semicapacity / 4;
+	int r;
+
+	r = libkeccak_digest(&state->leaf, NULL, 0, 0, LIBKECCAK_SHAKE_SUFFIX, cv);
+	if (r >= 0)
+		r = libkeccak_update(&state->final, cv, cvlen);
+	my_explicit_bzero(cv, cvlen);
+	if (r < 0)
+		return -1;
+
+	state->blocks += 1;
+	state->buffered = 0;
+	return 0;
+}
@@ -0,0 +1,38 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Hash ParallelHash blocks and absorb their
+ * chaining values into the final node
+ * 
+ * @param   state  The hashing state
+ * @param   data   The blocks, all but the last must be whole
+ * @param   len    The number of bytes in `data`
+ * @return         Zero on success, -1 on error
+ */
+int
+libkeccak_parallelhash_hash_blocks(struct libkeccak_parallelhash_state *restrict state, const unsigned char *restrict data,
+                                   size_t len)
+{
+	struct libkeccak_spec spec;
+	size_t n, count, size, cvlen = (size_t)state->semicapacity / 4;
+
+	/* The blocks are hashed with cSHAKE with empty function
+	 * name and customisation string, which is SHAKE */
+	libkeccak_spec_shake(&spec, state->semicapacity, (long int)cvlen * 8);
+
+	size = state->capacity * state->blocksize;
+	while (len) {
+		n = len < size ? len : size;
+		count = (n + state->blocksize - 1) / state->blocksize;
+		libkeccak_worker_pool_hash_leaves(state->pool, &spec, 0, LIBKECCAK_SHAKE_SUFFIX, data, n, state->blocksize, state->cvs);
+		if (libkeccak_update(&state->final, state->cvs, count * cvlen) < 0)
+			return -1;
+		state->blocks += count;
+		data = &data[n];
+		len -= n;
+	}
+
+	return 0;
+}
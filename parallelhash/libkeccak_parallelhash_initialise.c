@@ -0,0 +1,74 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_LEFT_ENCODE 1
+#include "../common.h"
+
+
+/**
+ * Initialise a ParallelHash hashing state
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `ParallelHashx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   blocksize     The block size, B, in bytes, must not be 0
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @param   pool          Worker pool used to hash the blocks,
+ *                        `NULL` to use only the calling thread
+ * @return                Zero on success, -1 on error
+ */
+int
+libkeccak_parallelhash_initialise(struct libkeccak_parallelhash_state *restrict state, long int semicapacity,
+                                  long int output, size_t blocksize, const void *restrict custom, size_t customlen,
+                                  struct libkeccak_worker_pool *pool)
+{
+	struct libkeccak_spec spec;
+	unsigned char encoded[sizeof(uintmax_t) + 1];
+	size_t n, per_thread;
+
+	if ((semicapacity != 128 && semicapacity != 256) || output <= 0 || !blocksize) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	per_thread = PARALLELHASH_BYTES_PER_THREAD / blocksize;
+	if (!per_thread)
+		per_thread = 1;
+	else if (per_thread > PARALLELHASH_MAX_BLOCKS_PER_THREAD)
+		per_thread = PARALLELHASH_MAX_BLOCKS_PER_THREAD;
+	state->capacity = per_thread * (pool ? pool->nthreads + 1 : 1);
+	if (blocksize > SIZE_MAX / state->capacity) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* The blocks are hashed with cSHAKE with empty function
+	 * name and customisation string, which is SHAKE */
+	libkeccak_spec_shake(&spec, semicapacity, semicapacity * 2);
+	if (libkeccak_state_initialise(&state->leaf, &spec) < 0)
+		return -1;
+
+	libkeccak_spec_cshake(&spec, semicapacity, output);
+	if (libkeccak_state_initialise(&state->final, &spec) < 0)
+		goto fail;
+	libkeccak_cshake_initialise(&state->final, PARALLELHASH_FUNCTION_NAME, sizeof(PARALLELHASH_FUNCTION_NAME) - 1,
+	                            0, NULL, custom, customlen, 0, NULL);
+
+	n = left_encode(encoded, blocksize);
+	if (libkeccak_update(&state->final, encoded, n) < 0) {
+		libkeccak_state_destroy(&state->final);
+		goto fail;
+	}
+
+	state->buffer = NULL;
+	state->cvs = NULL;
+	state->blocksize = blocksize;
+	state->buffered = 0;
+	state->blocks = 0;
+	state->semicapacity = semicapacity;
+	state->pool = pool;
+	return 0;
+
+fail:
+	libkeccak_state_destroy(&state->leaf);
+	return -1;
+}
@@ -0,0 +1,109 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Absorb more of the message to a ParallelHash hashing
+ * state whose blocks are absorbed into `.leaf` rather
+ * than collected in `.buffer`
+ * 
+ * @param   state   The hashing state
+ * @param   msg     The partial message
+ * @param   msglen  The length of the partial message, in bytes
+ * @return          Zero on success, -1 on error
+ */
+static int
+update_unbuffered(struct libkeccak_parallelhash_state *restrict state, const unsigned char *restrict msg, size_t msglen)
+{
+	size_t n;
+
+	if (state->buffered) {
+		n = state->blocksize - state->buffered;
+		n = msglen < n ? msglen : n;
+		if (libkeccak_update(&state->leaf, msg, n) < 0)
+			return -1;
+		state->buffered += n;
+		msg = &msg[n];
+		msglen -= n;
+		if (state->buffered < state->blocksize)
+			return 0;
+		if (libkeccak_parallelhash_finish_block(state) < 0)
+			return -1;
+	}
+
+	n = msglen - msglen % state->blocksize;
+	if (n) {
+		if (libkeccak_parallelhash_hash_blocks(state, msg, n) < 0)
+			return -1;
+		msg = &msg[n];
+		msglen -= n;
+	}
+
+	if (msglen) {
+		libkeccak_state_reset(&state->leaf);
+		if (libkeccak_update(&state->leaf, msg, msglen) < 0)
+			return -1;
+		state->buffered = msglen;
+	}
+	return 0;
+}
+
+
+/**
+ * Absorb more of the message to a ParallelHash hashing state
+ * 
+ * @param   state   The hashing state
+ * @param   msg_    The partial message
+ * @param   msglen  The length of the partial message, in bytes
+ * @return          Zero on success, -1 on error
+ */
+int
+libkeccak_parallelhash_update(struct libkeccak_parallelhash_state *restrict state, const void *restrict msg_, size_t msglen)
+{
+	const unsigned char *restrict msg = msg_;
+	size_t n, size = state->capacity * state->blocksize;
+
+	if (!msglen)
+		return 0;
+
+	if (!state->cvs) {
+		state->cvs = malloc(state->capacity * (size_t)state->semicapacity / 4);
+		if (PARALLELHASH_BUFFERED(state))
+			state->buffer = malloc(size);
+		if (!state->cvs || (PARALLELHASH_BUFFERED(state) && !state->buffer)) {
+			free(state->buffer);
+			free(state->cvs);
+			state->buffer = state->cvs = NULL;
+			return -1;
+		}
+	}
+
+	if (!PARALLELHASH_BUFFERED(state))
+		return update_unbuffered(state, msg, msglen);
+
+	if (state->buffered) {
+		n = size - state->buffered;
+		n = msglen < n ? msglen : n;
+		__builtin_memcpy(&state->buffer[state->buffered], msg, n);
+		state->buffered += n;
+		msg = &msg[n];
+		msglen -= n;
+		if (state->buffered < size)
+			return 0;
+		if (libkeccak_parallelhash_hash_blocks(state, state->buffer, size) < 0)
+			return -1;
+		state->buffered = 0;
+	}
+
+	n = msglen - msglen % size;
+	if (n) {
+		if (libkeccak_parallelhash_hash_blocks(state, msg, n) < 0)
+			return -1;
+		msg = &msg[n];
+		msglen -= n;
+	}
+
+	__builtin_memcpy(state->buffer, msg, msglen);
+	state->buffered = msglen;
+	return 0;
+}
@@ -0,0 +1,81 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Run tasks from a worker pool until it is stopped
+ * 
+ * @param   pool_  The worker pool
+ * @return         `NULL`
+ */
+static void *
+worker(void *pool_)
+{
+	struct libkeccak_worker_pool *pool = pool_;
+	size_t i;
+
+	pthread_mutex_lock(&pool->mutex);
+	for (;;) {
+		while (!pool->quit && pool->next >= pool->count)
+			pthread_cond_wait(&pool->work_cond, &pool->mutex);
+		if (pool->quit)
+			break;
+		i = pool->next++;
+		pool->busy++;
+		pthread_mutex_unlock(&pool->mutex);
+		pool->func(pool->data, i);
+		pthread_mutex_lock(&pool->mutex);
+		if (!--pool->busy && pool->next >= pool->count)
+			pthread_cond_signal(&pool->done_cond);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	return NULL;
+}
+
+
+/**
+ * Create a worker pool
+ * 
+ * @param   threads  The number of threads that shall work on a message,
+ *                   including the thread that is hashing the message;
+ *                   0 for the number of online CPUs
+ * @return           The worker pool, `NULL` on error
+ */
+struct libkeccak_worker_pool *
+libkeccak_worker_pool_create(size_t threads)
+{
+	struct libkeccak_worker_pool *pool;
+	long int cpus;
+	int err;
+
+	if (!threads) {
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cpus > 0 ? (size_t)cpus : 1;
+	}
+
+	pool = calloc(1, sizeof(*pool));
+	if (!pool)
+		return NULL;
+	pool->threads = calloc(threads - 1 ? threads - 1 : 1, sizeof(*pool->threads));
+	if (!pool->threads) {
+		free(pool);
+		return NULL;
+	}
+
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_mutex_init(&pool->run_mutex, NULL);
+	pthread_cond_init(&pool->work_cond, NULL);
+	pthread_cond_init(&pool->done_cond, NULL);
+
+	for (; pool->nthreads < threads - 1; pool->nthreads++) {
+		err = pthread_create(&pool->threads[pool->nthreads], NULL, worker, pool);
+		if (err) {
+			libkeccak_worker_pool_free(pool);
+			errno = err;
+			return NULL;
+		}
+	}
+
+	return pool;
+}
@@ -0,0 +1,128 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Leaves to hash with a worker pool
+ */
+struct leaves {
+	/**
+	 * The specifications for the leaves
+	 */
+	const struct libkeccak_spec *spec;
+
+	/**
+	 * The number of rounds, 0 for all rounds of Keccak-f
+	 */
+	long int rounds;
+
+	/**
+	 * The message suffix for the leaves
+	 */
+	const char *suffix;
+
+	/**
+	 * The leaves, concatenated
+	 */
+	const unsigned char *data;
+
+	/**
+	 * The number of bytes in `.data`
+	 */
+	size_t len;
+
+	/**
+	 * The size of a leaf, in bytes
+	 */
+	size_t leafsize;
+
+	/**
+	 * Output buffer for the chaining values
+	 */
+	unsigned char *cvs;
+
+	/**
+	 * The size of a chaining value, in bytes
+	 */
+	size_t cvlen;
+
+	/**
+	 * The number of leaves in each task
+	 */
+	size_t per_task;
+};
+
+
+/**
+ * Hash the leaves of one task
+ * 
+ * @param  leaves_  The leaves, `struct leaves *`
+ * @param  task     The index of the task
+ */
+static void
+hash_task(void *leaves_, size_t task)
+{
+	struct leaves *leaves = leaves_;
+	const void *msgs[LEAVES_PER_BATCH];
+	size_t lens[LEAVES_PER_BATCH];
+	void *outs[LEAVES_PER_BATCH];
+	size_t i, n, offset, end;
+
+	i = task * leaves->per_task;
+	end = i + leaves->per_task;
+	while (i < end) {
+		for (n = 0; n < LEAVES_PER_BATCH && i < end; n++, i++) {
+			offset = i * leaves->leafsize;
+			if (offset >= leaves->len) {
+				end = i;
+				break;
+			}
+			msgs[n] = &leaves->data[offset];
+			lens[n] = leaves->len - offset < leaves->leafsize ? leaves->len - offset : leaves->leafsize;
+			outs[n] = &leaves->cvs[i * leaves->cvlen];
+		}
+		if (leaves->rounds)
+			libkeccak_digest_many_rounds(leaves->spec, leaves->rounds, msgs, lens, leaves->suffix, outs, n);
+		else
+			libkeccak_digest_many(leaves->spec, msgs, lens, leaves->suffix, outs, n);
+	}
+}
+
+
+/**
+ * Hash independent leaves of a message, with the
+ * multi-buffer kernels and the threads of a worker pool
+ * 
+ * @param  pool      The worker pool, may be `NULL`
+ * @param  spec      The specifications for the leaves
+ * @param  rounds    The number of rounds, 0 for all rounds of Keccak-f
+ * @param  suffix    The message suffix for the leaves
+ * @param  data      The leaves, concatenated
+ * @param  len       The number of bytes in `data`, only the last leaf may be partial
+ * @param  leafsize  The size of a leaf, in bytes
+ * @param  cvs       Output buffer for the chaining values, concatenated,
+ *                   each `(spec->output + 7) / 8` bytes long
+ */
+void
+libkeccak_worker_pool_hash_leaves(struct libkeccak_worker_pool *pool, const struct libkeccak_spec *spec, long int rounds,
+                                  const char *suffix, const void *data, size_t len, size_t leafsize, void *cvs)
+{
+	struct leaves leaves;
+	size_t count, tasks;
+
+	count = (len + leafsize - 1) / leafsize;
+	tasks = (pool ? pool->nthreads + 1 : 1) * TASKS_PER_THREAD;
+
+	leaves.spec = spec;
+	leaves.rounds = rounds;
+	leaves.suffix = suffix;
+	leaves.data = data;
+	leaves.len = len;
+	leaves.leafsize = leafsize;
+	leaves.cvs = cvs;
+	leaves.cvlen = (size_t)((spec->output + 7) / 8);
+	leaves.per_task = (count + tasks - 1) / tasks;
+	leaves.per_task += (LEAVES_PER_BATCH - leaves.per_task % LEAVES_PER_BATCH) % LEAVES_PER_BATCH;
+
+	libkeccak_worker_pool_run(pool, hash_task, &leaves, (count + leaves.per_task - 1) / leaves.per_task);
+}
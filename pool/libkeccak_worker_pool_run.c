@@ -0,0 +1,48 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Run `func(data, i)` for each `i` in [0, `count`), spread
+ * over the threads in a worker pool and the calling thread,
+ * and wait for all of them to complete
+ * 
+ * @param  pool   The worker pool, `NULL` to run all tasks in the calling thread
+ * @param  func   The function that runs a task
+ * @param  data   The first argument for `func`
+ * @param  count  The number of tasks
+ */
+void
+libkeccak_worker_pool_run(struct libkeccak_worker_pool *pool, void (*func)(void *, size_t), void *data, size_t count)
+{
+	size_t i;
+
+	if (!pool || !pool->nthreads || count < 2) {
+		for (i = 0; i < count; i++)
+			func(data, i);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->run_mutex);
+	pthread_mutex_lock(&pool->mutex);
+	pool->func = func;
+	pool->data = data;
+	pool->next = 0;
+	pool->count = count;
+	pthread_cond_broadcast(&pool->work_cond);
+
+	while (pool->next < pool->count) {
+		i = pool->next++;
+		pool->busy++;
+		pthread_mutex_unlock(&pool->mutex);
+		func(data, i);
+		pthread_mutex_lock(&pool->mutex);
+		pool->busy--;
+	}
+	while (pool->busy)
+		pthread_cond_wait(&pool->done_cond, &pool->mutex);
+
+	pool->next = pool->count = 0;
+	pthread_mutex_unlock(&pool->mutex);
+	pthread_mutex_unlock(&pool->run_mutex);
+}
@@ -0,0 +1,5 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+extern inline const char *libkeccak_turboshake_suffix(int, char *);
@@ -1,6 +1,7 @@
 /* See LICENSE file for copyright and license details. */
 #include "libkeccak.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
@@ -72,8 +73,10 @@ test_state(struct libkeccak_spec *restrict spec)
 {
 	struct libkeccak_state *restrict state;
 	struct libkeccak_state *restrict state2;
-	size_t marshal_size, marshalled_size, i, n;
+	size_t marshal_size, marshalled_size, offset, i, n;
 	char *restrict marshalled_data;
+	uint64_t lane;
+	long int r;
 
 	state = libkeccak_state_create(spec);
 	if (!state) {
@@ -96,6 +99,9 @@ test_state(struct libkeccak_spec *restrict spec)
 		return -1;
 	}
 
+	for (i = 0; i < 25; i++)
+		state2->S.w64[i] = (uint64_t)i + 1;
+
 	marshal_size = libkeccak_state_marshal(state2, NULL);
 	marshalled_data = malloc(marshal_size);
 	if (!marshalled_data) {
@@ -109,6 +115,13 @@ test_state(struct libkeccak_spec *restrict spec)
 		return -1;
 	}
 
+	/* Marshalled sponges store lane (x, y) at index 5x + y */
+	memcpy(&lane, &marshalled_data[7 * sizeof(long int) + sizeof(uint64_t) + 5 * sizeof(uint64_t)], sizeof(lane));
+	if (state2->w == 64 && lane != state2->S.w64[1]) {
+		printf("Unexpected lane order in marshalled state.\n");
+		return -1;
+	}
+
 	libkeccak_state_free(state);
 
 	state = malloc(sizeof(struct libkeccak_state));
@@ -135,6 +148,29 @@ test_state(struct libkeccak_spec *restrict spec)
 		printf("Inconsistency found between original state and unmarshalled state.\n");
 		return -1;
 	}
+	if (memcmp(&state->S, &state2->S, sizeof(state->S))) {
+		printf("Inconsistency found between original sponge and unmarshalled sponge.\n");
+		return -1;
+	}
+
+	/* A whole block in the message buffer would overflow it on the next update */
+	offset = 7 * sizeof(long int) + sizeof(uint64_t) + sizeof(state->S);
+	n = (size_t)(state2->r >> 3);
+	memcpy(&marshalled_data[offset], &n, sizeof(n));
+	if ((errno = 0, libkeccak_state_unmarshal(state, marshalled_data)) || errno != EINVAL) {
+		printf("libkeccak_state_unmarshal accepted a full message buffer.\n");
+		return -1;
+	}
+	n = (size_t)state2->mptr;
+	memcpy(&marshalled_data[offset], &n, sizeof(n));
+
+	/* So would a bitrate larger than the message buffer */
+	r = 2400;
+	memcpy(&marshalled_data[0], &r, sizeof(r));
+	if ((errno = 0, libkeccak_state_unmarshal(state, marshalled_data)) || errno != EINVAL) {
+		printf("libkeccak_state_unmarshal accepted an invalid bitrate.\n");
+		return -1;
+	}
 
 	free(marshalled_data);
 	libkeccak_state_free(state);
@@ -220,6 +256,35 @@ test_digest_case(const struct libkeccak_spec *restrict spec, const char *restric
 }
 
 
+/**
+ * Run a test case for `libkeccak_digest` with
+ * a reduced number of rounds
+ * 
+ * @param   spec             The specification for the hashing
+ * @param   rounds           The number of rounds
+ * @param   suffix           The message suffix (padding prefix)
+ * @param   msg              The message to digest
+ * @param   bytes            Number of while bytes in `msg`
+ * @param   bits             Bits at the end of `msg` that does not make up a whole byte
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_digest_case_rounds(const struct libkeccak_spec *restrict spec, long int rounds, const char *restrict suffix,
+                        const char *restrict msg, size_t bytes, size_t bits, const char *restrict expected_answer)
+{
+	struct libkeccak_state state;
+	int ret;
+	if (libkeccak_state_initialise_rounds(&state, spec, rounds)) {
+		perror("libkeccak_state_initialise_rounds");
+		return -1;
+	}
+	ret = test_digest_case_inited(&state, spec, suffix, msg, bytes, bits, expected_answer);
+	libkeccak_state_fast_destroy(&state);
+	return ret;
+}
+
+
 /**
  * Run a test case for `libkeccak_digest` with cSHAKE
  * 
@@ -939,6 +1004,114 @@ test_digest_trunc(void)
 }
 
 
+/**
+ * Run test cases for `libkeccak_digest` with
+ * a reduced number of rounds
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_digest_rounds(void)
+{
+#define turboshake(semicapacity, output, message, length, domain)\
+	(printf("  Testing TurboSHAKE%i(%s, 0x%02X, %i): ", semicapacity, #message, domain, output),\
+	 libkeccak_spec_shake(&spec, semicapacity, output),\
+	 test_digest_case_rounds(&spec, LIBKECCAK_TURBOSHAKE_ROUNDS, libkeccak_turboshake_suffix(domain, suffix),\
+	                         message, length, 0, answer))
+
+#define keccak_p(semicapacity, output, nr, message, length, suffix)\
+	(printf("  Testing Keccak-p[1600, %i][c=%i](%s, %i): ", nr, 2 * semicapacity, #message, output),\
+	 libkeccak_spec_rawshake(&spec, semicapacity, output),\
+	 test_digest_case_rounds(&spec, nr, suffix, message, length, 0, answer))
+
+	struct libkeccak_state state;
+	struct libkeccak_spec spec;
+	const char *answer;
+	char suffix[8];
+	char ptn[300];
+	size_t i;
+
+	printf("Testing libkeccak_digest with a reduced number of rounds:\n");
+
+	for (i = 0; i < sizeof(ptn); i++)
+		ptn[i] = (char)(i % 251);
+
+	if (strcmp(libkeccak_turboshake_suffix(0x1F, suffix), LIBKECCAK_TURBOSHAKE_SUFFIX) ||
+	    strcmp(libkeccak_turboshake_suffix(0x01, suffix), "") ||
+	    strcmp(libkeccak_turboshake_suffix(0x06, suffix), "01") ||
+	    strcmp(libkeccak_turboshake_suffix(0x0B, suffix), "110")) {
+		printf("  libkeccak_turboshake_suffix returned the wrong suffix\n");
+		return -1;
+	}
+
+	libkeccak_spec_shake(&spec, 128, 256);
+	if ((errno = 0, libkeccak_state_initialise_rounds(&state, &spec, 0) != -1) || errno != EINVAL ||
+	    (errno = 0, libkeccak_state_initialise_rounds(&state, &spec, 25) != -1) || errno != EINVAL ||
+	    libkeccak_state_initialise_rounds(&state, &spec, 24) || state.nr != 24 ||
+	    libkeccak_turboshake_initialise(&state, 128, 256) || state.nr != 12 || state.r != 1344 ||
+	    (spec.bitrate = 64, spec.capacity = 136, errno = 0,
+	     libkeccak_state_initialise_rounds(&state, &spec, 19) != -1) || errno != EINVAL ||
+	    libkeccak_state_initialise_rounds(&state, &spec, 18) || state.nr != 18 ||
+	    (spec.output = 0, errno = 0, libkeccak_state_initialise(&state, &spec) != -1) || errno != EINVAL) {
+		printf("  libkeccak_state_initialise_rounds did not check the number of rounds correctly\n");
+		return -1;
+	}
+
+	answer = "1e415f1c5983aff2169217277d17bb538cd945a397ddec541f1ce41af2c1b74c";
+	if (turboshake(128, 256, "", 0, 0x1F))
+		return -1;
+
+	answer = "9c97d036a3bac819db70ede0ca554ec6e4c2a1a4ffbfd9ec269ca6a111161233";
+	if (turboshake(128, 256, ptn, 17, 0x1F))
+		return -1;
+
+	answer = "96c77c279e0126f7fc07c9b07f5cdae1e0be60bdbe10620040e75d7223a624d2";
+	if (turboshake(128, 256, ptn, 289, 0x1F))
+		return -1;
+
+	answer = "bf323f940494e88ee1c540fe660be8a0c93f43d15ec006998462fa994eed5dab";
+	if (turboshake(128, 256, "\xff\xff\xff", 3, 0x01))
+		return -1;
+
+	answer = "8ec9c66465ed0d4a6c35d13506718d687a25cb05c74cca1e42501abd83874a67";
+	if (turboshake(128, 256, "\xff", 1, 0x06))
+		return -1;
+
+	answer = "b658576001cad9b1e5f399a9f77723bba05458042d68206f7252682dba3663ed";
+	if (turboshake(128, 256, "\xff\xff\xff", 3, 0x07))
+		return -1;
+
+	answer = "367a329dafea871c7802ec67f905ae13c57695dc2c6663c61035f59a18f8e7db"
+	         "11edc0e12e91ea60eb6b32df06dd7f002fbafabb6e13ec1cc20d995547600db0";
+	if (turboshake(256, 512, "", 0, 0x1F))
+		return -1;
+
+	answer = "66b810db8e90780424c0847372fdc95710882fde31c6df75beb9d4cd9305cfca"
+	         "e35e7b83e8b7e6eb4b78605880116316fe2c078a09b94ad7b8213c0a738b65c0";
+	if (turboshake(256, 512, ptn, 289, 0x1F))
+		return -1;
+
+	answer = "392d9f3b03b6c5c461894070185950bb5df41996bf2ca8e33e04d4f94c46953f";
+	if (keccak_p(128, 256, 13, "abc", 3, LIBKECCAK_SHAKE_SUFFIX))
+		return -1;
+
+	answer = "69e2639f00000080f60100000018263600c030b1b10f00006122430e00000000";
+	if (keccak_p(128, 256, 1, "abc", 3, LIBKECCAK_SHAKE_SUFFIX))
+		return -1;
+
+	answer = "04da1ddd11ae158299661ca0bbd8d77ba0337486246c9c84563819a374ac17d4"
+	         "01df339aed9b6c18df609eb45d313c10848cbad2603b96b2d8512137551b773d";
+	if (keccak_p(256, 512, 23, ptn, 300, LIBKECCAK_SHA3_SUFFIX))
+		return -1;
+
+	printf("\n");
+	return 0;
+
+#undef turboshake
+#undef keccak_p
+}
+
+
 /**
  * Run a test case for `libkeccak_update`
  * 
@@ -1062,6 +1235,99 @@ test_update(void)
 }
 
 
+/**
+ * Run a test case for absorbing a message in chunks
+ * of varying sizes, mixing the update functions, and
+ * finishing with `libkeccak_zerocopy_digest`
+ * 
+ * @param   spec    The specification for the hashing
+ * @param   suffix  The message suffix (padding prefix)
+ * @return          Zero on success, -1 on error
+ */
+static int
+test_update_chunked_case(const struct libkeccak_spec *restrict spec, const char *restrict suffix)
+{
+	static const size_t chunks[] = {0, 1, 70, 136, 137, 3, 272, 5, 8, 199, 25};
+	struct libkeccak_state state;
+	unsigned char msg[1000], hashsum[512], expected[512];
+	size_t i, off, len, hashlen = (size_t)((spec->output + 7) / 8);
+
+	for (i = 0; i < sizeof(msg); i++)
+		msg[i] = (unsigned char)(i * 13 + 7);
+
+	if (libkeccak_state_initialise(&state, spec)) {
+		perror("libkeccak_state_initialise");
+		return -1;
+	}
+	if (libkeccak_digest(&state, msg, sizeof(msg), 0, suffix, expected)) {
+		perror("libkeccak_digest");
+		return -1;
+	}
+	libkeccak_state_fast_destroy(&state);
+
+	if (libkeccak_state_initialise(&state, spec)) {
+		perror("libkeccak_state_initialise");
+		return -1;
+	}
+	for (i = off = 0; off < sizeof(msg) - 37; i++, off += len) {
+		len = chunks[i % (sizeof(chunks) / sizeof(*chunks))];
+		if (len > sizeof(msg) - 37 - off)
+			len = sizeof(msg) - 37 - off;
+		if (i % 3 == 0) {
+			libkeccak_zerocopy_update(&state, &msg[off], len);
+		} else if (i % 3 == 1 ? libkeccak_fast_update(&state, &msg[off], len)
+		                      : libkeccak_update(&state, &msg[off], len)) {
+			perror("libkeccak_update");
+			return -1;
+		}
+	}
+	libkeccak_zerocopy_digest(&state, &msg[off], sizeof(msg) - off, 0, suffix, hashsum);
+	libkeccak_state_fast_destroy(&state);
+
+	if (memcmp(hashsum, expected, hashlen)) {
+		printf("Fail\n");
+		printf("  r, c, n = %li, %li, %li\n", spec->bitrate, spec->capacity, spec->output);
+		return -1;
+	}
+	printf("OK\n");
+	return 0;
+}
+
+
+/**
+ * Run test cases for absorbing a message in chunks
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_update_chunked(void)
+{
+	struct libkeccak_spec spec;
+
+	printf("Testing chunked updates:\n");
+
+	printf("  Testing SHA3-256: ");
+	libkeccak_spec_sha3(&spec, 256);
+	if (test_update_chunked_case(&spec, LIBKECCAK_SHA3_SUFFIX))
+		return -1;
+
+	printf("  Testing SHAKE256: ");
+	libkeccak_spec_shake(&spec, 256, 4000);
+	if (test_update_chunked_case(&spec, LIBKECCAK_SHAKE_SUFFIX))
+		return -1;
+
+	printf("  Testing Keccak[r = 64, c = 136, n = 256]: ");
+	spec.bitrate = 64;
+	spec.capacity = 136;
+	spec.output = 256;
+	if (test_update_chunked_case(&spec, ""))
+		return -1;
+
+	printf("\n");
+	return 0;
+}
+
+
 /**
  * Run a test for `libkeccak_*squeeze` functions
  * 
@@ -1190,6 +1456,1565 @@ test_squeeze(void)
 }
 
 
+/**
+ * Run a test case for `libkeccak_digest_many`
+ * or `libkeccak_digest_many_rounds`
+ * 
+ * @param   spec    The specification for the hashing
+ * @param   rounds  The number of rounds, 0 to use `libkeccak_digest_many`
+ * @param   suffix  The message suffix (padding prefix)
+ * @param   n       The number of messages to digest
+ * @return          Zero on success, -1 on error
+ */
+static int
+test_digest_many_case(const struct libkeccak_spec *restrict spec, long int rounds, const char *restrict suffix, size_t n)
+{
+#define MAX_MESSAGES 40
+	static const size_t sizes[] = {0, 1, 135, 136, 137, 71, 72, 300, 1000};
+	struct libkeccak_state state;
+	unsigned char messages[MAX_MESSAGES][1000];
+	unsigned char expected[MAX_MESSAGES][512];
+	unsigned char hashsums[MAX_MESSAGES][512];
+	const void *msgs[MAX_MESSAGES];
+	void *outs[MAX_MESSAGES];
+	size_t lens[MAX_MESSAGES], i, j;
+	size_t hashsize = (size_t)((spec->output + 7) / 8);
+
+	for (i = 0; i < n; i++) {
+		lens[i] = sizes[(i * 5 + n) % (sizeof(sizes) / sizeof(*sizes))];
+		for (j = 0; j < lens[i]; j++)
+			messages[i][j] = (unsigned char)(i * 31 + j * 7);
+		msgs[i] = lens[i] ? messages[i] : NULL;
+		outs[i] = hashsums[i];
+		if (rounds ? libkeccak_state_initialise_rounds(&state, spec, rounds) : libkeccak_state_initialise(&state, spec)) {
+			perror("libkeccak_state_initialise");
+			return -1;
+		}
+		if (libkeccak_digest(&state, msgs[i], lens[i], 0, suffix, expected[i])) {
+			perror("libkeccak_digest");
+			return -1;
+		}
+		libkeccak_state_fast_destroy(&state);
+	}
+
+	if (rounds ? libkeccak_digest_many_rounds(spec, rounds, msgs, lens, suffix, outs, n)
+	           : libkeccak_digest_many(spec, msgs, lens, suffix, outs, n)) {
+		perror("libkeccak_digest_many");
+		return -1;
+	}
+
+	for (i = 0; i < n; i++) {
+		if (memcmp(hashsums[i], expected[i], hashsize)) {
+			printf("Fail: message %zu\n", i);
+			printf("  r, c, n = %li, %li, %li\n", spec->bitrate, spec->capacity, spec->output);
+			return -1;
+		}
+	}
+
+	printf("OK\n");
+	return 0;
+#undef MAX_MESSAGES
+}
+
+
+/**
+ * Test `libkeccak_digest_many`
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_digest_many(void)
+{
+#define sha3(output, n)\
+	(printf("  Testing SHA3-"#output" with "#n" messages: "),\
+	 libkeccak_spec_sha3(&spec, output),\
+	 test_digest_many_case(&spec, 0, LIBKECCAK_SHA3_SUFFIX, n))
+
+#define shake(semicapacity, output, n)\
+	(printf("  Testing SHAKE-"#semicapacity"(%i) with "#n" messages: ", output),\
+	 libkeccak_spec_shake(&spec, semicapacity, output),\
+	 test_digest_many_case(&spec, 0, LIBKECCAK_SHAKE_SUFFIX, n))
+
+#define keccak_g(b, c, o, n)\
+	(printf("  Testing Keccak[%i,%i,%i] with "#n" messages: ", b, c, o),\
+	 spec.bitrate = b, spec.capacity = c, spec.output = o,\
+	 test_digest_many_case(&spec, 0, "", n))
+
+#define keccak_p(b, c, o, nr, n)\
+	(printf("  Testing Keccak-p[%i,%i][%i,%i] with "#n" messages: ", b + c, nr, b, c),\
+	 spec.bitrate = b, spec.capacity = c, spec.output = o,\
+	 test_digest_many_case(&spec, nr, "", n))
+
+	struct libkeccak_spec spec;
+
+	printf("Testing libkeccak_digest_many:\n");
+
+	if (sha3(224, 1) || sha3(224, 4) || sha3(256, 5) || sha3(384, 8) || sha3(512, 9) ||
+	    shake(128, 4000, 3) || shake(256, 4000, 9) ||
+	    keccak_g(1024, 576, 256, 7) || keccak_g(800, 800, 1600, 6) ||
+	    keccak_g(576, 224, 256, 5) || keccak_g(576, 224, 256, 17) || keccak_g(256, 144, 224, 33) ||
+	    keccak_g(160, 40, 200, 4) || keccak_g(160, 40, 200, 40) || keccak_g(104, 96, 100, 32) ||
+	    keccak_p(1344, 256, 256, 12, 9) || keccak_p(576, 224, 256, 7, 17) ||
+	    keccak_p(256, 144, 224, 10, 33) || keccak_p(160, 40, 200, 1, 40))
+		return -1;
+
+	printf("\n");
+	return 0;
+
+#undef sha3
+#undef shake
+#undef keccak_g
+#undef keccak_p
+}
+
+
+
+/**
+ * Run a test case for `libkeccak_digest_pair`
+ * 
+ * @param   spec    The specification for the hashing
+ * @param   suffix  The message suffix (padding prefix)
+ * @param   pre1    The number of bytes to feed to the first state before the digest
+ * @param   len1    The number of bytes of the first message to pass to the digest
+ * @param   bits1   The number of additional bits of the first message
+ * @param   pre2    The number of bytes to feed to the second state before the digest
+ * @param   len2    The number of bytes of the second message to pass to the digest
+ * @param   bits2   The number of additional bits of the second message
+ * @return          Zero on success, -1 on error
+ */
+static int
+test_digest_pair_case(const struct libkeccak_spec *restrict spec, const char *restrict suffix,
+                      size_t pre1, size_t len1, size_t bits1, size_t pre2, size_t len2, size_t bits2)
+{
+	struct libkeccak_state state[4];
+	unsigned char message1[2048], message2[2048];
+	unsigned char expected1[512], expected2[512];
+	unsigned char hashsum1[512], hashsum2[512];
+	size_t hashsize = (size_t)((spec->output + 7) / 8);
+	size_t i;
+
+	for (i = 0; i < sizeof(message1); i++) {
+		message1[i] = (unsigned char)(i * 13 + 5);
+		message2[i] = (unsigned char)(i * 7 + 1);
+	}
+
+	for (i = 0; i < 4; i++) {
+		if (libkeccak_state_initialise(&state[i], spec)) {
+			perror("libkeccak_state_initialise");
+			return -1;
+		}
+		if (libkeccak_update(&state[i], (i & 1) ? message2 : message1, (i & 1) ? pre2 : pre1)) {
+			perror("libkeccak_update");
+			return -1;
+		}
+	}
+
+	if (libkeccak_digest(&state[0], len1 || bits1 ? &message1[pre1] : NULL, len1, bits1, suffix, expected1) ||
+	    libkeccak_digest(&state[1], len2 || bits2 ? &message2[pre2] : NULL, len2, bits2, suffix, expected2)) {
+		perror("libkeccak_digest");
+		return -1;
+	}
+	if (libkeccak_digest_pair(&state[2], len1 || bits1 ? &message1[pre1] : NULL, len1, bits1,
+	                          &state[3], len2 || bits2 ? &message2[pre2] : NULL, len2, bits2,
+	                          suffix, hashsum1, hashsum2)) {
+		perror("libkeccak_digest_pair");
+		return -1;
+	}
+
+	if (memcmp(hashsum1, expected1, hashsize) || memcmp(hashsum2, expected2, hashsize)) {
+		printf("Fail: digest\n");
+		return -1;
+	}
+
+	libkeccak_squeeze(&state[0], expected1);
+	libkeccak_squeeze(&state[1], expected2);
+	libkeccak_squeeze(&state[2], hashsum1);
+	libkeccak_squeeze(&state[3], hashsum2);
+	if (memcmp(hashsum1, expected1, hashsize) || memcmp(hashsum2, expected2, hashsize)) {
+		printf("Fail: squeeze\n");
+		return -1;
+	}
+
+	for (i = 0; i < 4; i++)
+		libkeccak_state_fast_destroy(&state[i]);
+
+	printf("OK\n");
+	return 0;
+}
+
+
+/**
+ * Run a test case for `libkeccak_hmac_digest_pair`
+ * 
+ * @param   spec     The specification for the hashing
+ * @param   suffix   The message suffix (padding prefix)
+ * @param   keylen1  The length of the first key, in bits
+ * @param   keylen2  The length of the second key, in bits
+ * @param   len1     The length of the first message, in bytes
+ * @param   len2     The length of the second message, in bytes
+ * @return           Zero on success, -1 on error
+ */
+static int
+test_hmac_digest_pair_case(const struct libkeccak_spec *restrict spec, const char *restrict suffix,
+                           size_t keylen1, size_t keylen2, size_t len1, size_t len2)
+{
+	struct libkeccak_hmac_state state[4];
+	unsigned char key1[256], key2[256], message1[1000], message2[1000];
+	unsigned char expected1[512], expected2[512];
+	unsigned char hashsum1[512], hashsum2[512];
+	size_t hashsize = (size_t)((spec->output + 7) / 8);
+	size_t i;
+
+	for (i = 0; i < sizeof(key1); i++) {
+		key1[i] = (unsigned char)(i * 3 + 11);
+		key2[i] = (unsigned char)(i * 5 + 17);
+	}
+	for (i = 0; i < sizeof(message1); i++) {
+		message1[i] = (unsigned char)(i * 13 + 5);
+		message2[i] = (unsigned char)(i * 7 + 1);
+	}
+
+	for (i = 0; i < 4; i++) {
+		if (libkeccak_hmac_initialise(&state[i], spec, (i & 1) ? key2 : key1, (i & 1) ? keylen2 : keylen1)) {
+			perror("libkeccak_hmac_initialise");
+			return -1;
+		}
+	}
+
+	if (libkeccak_hmac_digest(&state[0], message1, len1, 0, suffix, expected1) ||
+	    libkeccak_hmac_digest(&state[1], message2, len2, 0, suffix, expected2)) {
+		perror("libkeccak_hmac_digest");
+		return -1;
+	}
+	if (libkeccak_hmac_digest_pair(&state[2], message1, len1, 0, &state[3], message2, len2, 0,
+	                               suffix, hashsum1, hashsum2)) {
+		perror("libkeccak_hmac_digest_pair");
+		return -1;
+	}
+
+	for (i = 0; i < 4; i++)
+		libkeccak_hmac_fast_destroy(&state[i]);
+
+	if (memcmp(hashsum1, expected1, hashsize) || memcmp(hashsum2, expected2, hashsize)) {
+		printf("Fail\n");
+		return -1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
+
+
+/**
+ * Test `libkeccak_digest_pair` and `libkeccak_hmac_digest_pair`
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_digest_pair(void)
+{
+#define sha3(output, pre1, len1, bits1, pre2, len2, bits2)\
+	(printf("  Testing SHA3-"#output" with ("#pre1", "#len1", "#bits1") and ("#pre2", "#len2", "#bits2"): "),\
+	 libkeccak_spec_sha3(&spec, output),\
+	 test_digest_pair_case(&spec, LIBKECCAK_SHA3_SUFFIX, pre1, len1, bits1, pre2, len2, bits2))
+
+#define shake(semicapacity, output, pre1, len1, pre2, len2)\
+	(printf("  Testing SHAKE-"#semicapacity"(%i) with ("#pre1", "#len1") and ("#pre2", "#len2"): ", output),\
+	 libkeccak_spec_shake(&spec, semicapacity, output),\
+	 test_digest_pair_case(&spec, LIBKECCAK_SHAKE_SUFFIX, pre1, len1, 0, pre2, len2, 0))
+
+#define keccak_g(b, c, o, pre1, len1, pre2, len2)\
+	(printf("  Testing Keccak[%i,%i,%i] with ("#pre1", "#len1") and ("#pre2", "#len2"): ", b, c, o),\
+	 spec.bitrate = b, spec.capacity = c, spec.output = o,\
+	 test_digest_pair_case(&spec, "", pre1, len1, 0, pre2, len2, 0))
+
+#define hmac(output, keylen1, keylen2, len1, len2)\
+	(printf("  Testing HMAC-SHA3-"#output" with "#keylen1"-bit and "#keylen2"-bit keys: "),\
+	 libkeccak_spec_sha3(&spec, output),\
+	 test_hmac_digest_pair_case(&spec, LIBKECCAK_SHA3_SUFFIX, keylen1, keylen2, len1, len2))
+
+	struct libkeccak_spec spec;
+
+	printf("Testing libkeccak_digest_pair:\n");
+
+	if (sha3(224, 0, 0, 0, 0, 0, 0) || sha3(256, 0, 1000, 0, 0, 1000, 0) || sha3(256, 0, 136, 0, 0, 135, 0) ||
+	    sha3(256, 10, 300, 0, 100, 7, 0) || sha3(384, 0, 3, 5, 0, 200, 3) || sha3(512, 71, 72, 7, 1, 500, 1) ||
+	    shake(128, 4000, 0, 1000, 0, 1000) || shake(256, 4000, 13, 600, 200, 0) ||
+	    keccak_g(1024, 576, 256, 5, 1000, 5, 1000) || keccak_g(800, 800, 1600, 0, 50, 0, 500) ||
+	    keccak_g(576, 224, 256, 3, 100, 0, 100) || keccak_g(160, 40, 200, 1, 900, 0, 300) ||
+	    hmac(256, 64, 64, 300, 200) || hmac(224, 800, 1200, 1000, 0) || hmac(512, 2000, 8, 5, 500) ||
+	    hmac(256, 63, 64, 300, 200))
+		return -1;
+
+	printf("\n");
+	return 0;
+
+#undef sha3
+#undef shake
+#undef keccak_g
+#undef hmac
+}
+
+
+/**
+ * Test the multi-buffer job manager
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_job_manager(void)
+{
+#define JOBS 300
+	static unsigned char message[1200];
+	static unsigned char hashsums[JOBS][512];
+	static struct libkeccak_job jobs[JOBS];
+	struct libkeccak_spec specs[9];
+	const char *suffixes[9];
+	struct libkeccak_job_manager *manager;
+	struct libkeccak_job *job;
+	struct libkeccak_state state;
+	unsigned char expected[512];
+	char done[JOBS];
+	size_t i, n = 0;
+
+	printf("Testing libkeccak_job_manager with mixed algorithms and lengths: ");
+
+	for (i = 0; i < sizeof(message); i++)
+		message[i] = (unsigned char)(i * 13 + 5);
+
+	libkeccak_spec_sha3(&specs[0], 224), suffixes[0] = LIBKECCAK_SHA3_SUFFIX;
+	libkeccak_spec_sha3(&specs[1], 256), suffixes[1] = LIBKECCAK_SHA3_SUFFIX;
+	libkeccak_spec_sha3(&specs[2], 384), suffixes[2] = LIBKECCAK_SHA3_SUFFIX;
+	libkeccak_spec_sha3(&specs[3], 512), suffixes[3] = LIBKECCAK_SHA3_SUFFIX;
+	libkeccak_spec_shake(&specs[4], 128, 300), suffixes[4] = LIBKECCAK_SHAKE_SUFFIX;
+	libkeccak_spec_shake(&specs[5], 256, 4000), suffixes[5] = LIBKECCAK_SHAKE_SUFFIX;
+	specs[6].bitrate = 576, specs[6].capacity = 224, specs[6].output = 256, suffixes[6] = "";
+	specs[7].bitrate = 160, specs[7].capacity = 40, specs[7].output = 203, suffixes[7] = NULL;
+	specs[8].bitrate = 256, specs[8].capacity = 144, specs[8].output = 100, suffixes[8] = "";
+
+	manager = libkeccak_job_manager_create();
+	if (!manager) {
+		perror("libkeccak_job_manager_create");
+		return -1;
+	}
+
+	for (i = 0; i < JOBS; i++) {
+		done[i] = 0;
+		jobs[i].spec = &specs[(i * 5 + i / 40) % 9];
+		jobs[i].msglen = (i * 37) % 7 ? (i * 131) % sizeof(message) : (i * 7) % 40;
+		jobs[i].msg = jobs[i].msglen ? message : NULL;
+		jobs[i].suffix = suffixes[(i * 5 + i / 40) % 9];
+		jobs[i].hashsum = hashsums[i];
+		jobs[i].user_data = &done[i];
+		if (libkeccak_job_manager_submit(manager, &jobs[i])) {
+			perror("libkeccak_job_manager_submit");
+			goto fail;
+		}
+		while (i % 17 == 16 ? (job = libkeccak_job_manager_flush(manager)) : (job = libkeccak_job_manager_get_completed(manager))) {
+			++*(char *)job->user_data;
+			n++;
+		}
+	}
+	while ((job = libkeccak_job_manager_flush(manager))) {
+		++*(char *)job->user_data;
+		n++;
+	}
+
+	if (n != JOBS) {
+		printf("Fail: %zu jobs completed, expected %i\n", n, JOBS);
+		goto fail;
+	}
+
+	for (i = 0; i < JOBS; i++) {
+		if (done[i] != 1) {
+			printf("Fail: job %zu completed %i times\n", i, done[i]);
+			goto fail;
+		}
+		libkeccak_state_initialise(&state, jobs[i].spec);
+		libkeccak_digest(&state, jobs[i].msg, jobs[i].msglen, 0, jobs[i].suffix, expected);
+		libkeccak_state_fast_destroy(&state);
+		if (memcmp(hashsums[i], expected, (size_t)((jobs[i].spec->output + 7) / 8))) {
+			printf("Fail: job %zu\n", i);
+			goto fail;
+		}
+	}
+
+	libkeccak_job_manager_free(manager);
+	printf("OK\n\n");
+	return 0;
+
+fail:
+	libkeccak_job_manager_free(manager);
+	return -1;
+#undef JOBS
+}
+
+
+/**
+ * Run a test case for `struct libkeccak_state_batch`
+ * 
+ * @param   spec   The specification for the hashing
+ * @param   pad    The first byte of the padded block for an empty tail
+ *                 of a message, that is, the suffix and the first bit
+ *                 of the 10*1-pad
+ * @param   count  The number of states in the batch
+ * @return         Zero on success, -1 on error
+ */
+static int
+test_state_batch_case(const struct libkeccak_spec *restrict spec, unsigned char pad, size_t count)
+{
+#define BLOCKS 3
+	static unsigned char messages[40][(BLOCKS + 1) * 200];
+	static unsigned char hashsums[40][512];
+	static unsigned char expected[512];
+	const void *msgs[40], *pads[40];
+	void *outs[40];
+	struct libkeccak_state_batch batch;
+	struct libkeccak_state state;
+	const char *suffix = pad == 0x06 ? LIBKECCAK_SHA3_SUFFIX : pad == 0x1F ? LIBKECCAK_SHAKE_SUFFIX : "";
+	size_t rr = (size_t)(spec->bitrate / 8), hashsize = (size_t)((spec->output + 7) / 8), i, k;
+
+	for (k = 0; k < count; k++) {
+		for (i = 0; i < BLOCKS * rr; i++)
+			messages[k][i] = (unsigned char)(i * 13 + k * 7 + 5);
+		messages[k][BLOCKS * rr] = pad;
+		__builtin_memset(&messages[k][BLOCKS * rr + 1], 0, rr - 1);
+		messages[k][(BLOCKS + 1) * rr - 1] |= 0x80;
+		msgs[k] = messages[k];
+		pads[k] = &messages[k][BLOCKS * rr];
+		outs[k] = hashsums[k];
+	}
+
+	if (libkeccak_state_batch_initialise(&batch, spec, count)) {
+		perror("libkeccak_state_batch_initialise");
+		return -1;
+	}
+
+	/* Absorb the first block in the batch, the next in individual states, and the rest in the batch */
+	libkeccak_state_batch_absorb(&batch, msgs, rr);
+	for (k = 0; k < count; k++) {
+		libkeccak_state_batch_extract(&batch, k, &state);
+		if (libkeccak_update(&state, &messages[k][rr], rr)) {
+			perror("libkeccak_update");
+			goto fail;
+		}
+		if (libkeccak_state_batch_insert(&batch, k, &state)) {
+			perror("libkeccak_state_batch_insert");
+			goto fail;
+		}
+		msgs[k] = &messages[k][2 * rr];
+	}
+	libkeccak_state_batch_absorb(&batch, msgs, (BLOCKS - 2) * rr);
+	libkeccak_state_batch_absorb(&batch, pads, rr);
+	libkeccak_state_batch_squeeze(&batch, outs);
+
+	for (k = 0; k < count; k++) {
+		libkeccak_state_initialise(&state, spec);
+		libkeccak_digest(&state, messages[k], BLOCKS * rr, 0, suffix, expected);
+		if (memcmp(hashsums[k], expected, hashsize)) {
+			printf("Fail: digest of message %zu\n", k);
+			goto fail;
+		}
+		outs[k] = k % 3 ? hashsums[k] : NULL;
+	}
+
+	libkeccak_state_batch_permute(&batch);
+	libkeccak_state_batch_squeeze(&batch, outs);
+	for (k = 0; k < count; k++) {
+		libkeccak_state_initialise(&state, spec);
+		libkeccak_digest(&state, messages[k], BLOCKS * rr, 0, suffix, NULL);
+		libkeccak_squeeze(&state, expected);
+		if (k % 3 && memcmp(hashsums[k], expected, hashsize)) {
+			printf("Fail: second squeeze of message %zu\n", k);
+			goto fail;
+		}
+	}
+
+	libkeccak_state_batch_reset(&batch);
+	libkeccak_state_batch_extract(&batch, count - 1, &state);
+	for (i = 0; i < 25; i++) {
+		if (state.S.w64[i]) {
+			printf("Fail: reset\n");
+			goto fail;
+		}
+	}
+
+	libkeccak_state_batch_destroy(&batch);
+	printf("OK\n");
+	return 0;
+
+fail:
+	libkeccak_state_batch_destroy(&batch);
+	return -1;
+#undef BLOCKS
+}
+
+
+/**
+ * Test `struct libkeccak_state_batch`
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_state_batch(void)
+{
+#define sha3(output, count)\
+	(printf("  Testing SHA3-"#output" with %i states: ", count),\
+	 libkeccak_spec_sha3(&spec, output),\
+	 test_state_batch_case(&spec, 0x06, count))
+
+#define shake(semicapacity, output, count)\
+	(printf("  Testing SHAKE-"#semicapacity"(%i) with %i states: ", output, count),\
+	 libkeccak_spec_shake(&spec, semicapacity, output),\
+	 test_state_batch_case(&spec, 0x1F, count))
+
+#define keccak_g(b, c, o, count)\
+	(printf("  Testing Keccak[%i,%i,%i] with %i states: ", b, c, o, count),\
+	 spec.bitrate = b, spec.capacity = c, spec.output = o,\
+	 test_state_batch_case(&spec, 0x01, count))
+
+	struct libkeccak_spec spec;
+
+	printf("Testing libkeccak_state_batch:\n");
+
+	if (sha3(256, 1) || sha3(512, 4) || sha3(224, 7) ||
+	    shake(128, 4000, 9) || shake(256, 2000, 4) ||
+	    keccak_g(576, 224, 256, 8) || keccak_g(256, 144, 1000, 21) ||
+	    keccak_g(160, 40, 200, 32) || keccak_g(104, 96, 100, 40))
+		return -1;
+
+	printf("\n");
+	return 0;
+
+#undef sha3
+#undef shake
+#undef keccak_g
+}
+
+
+/**
+ * Run a test case for KangarooTwelve
+ * 
+ * @param   semicapacity     The value of x in `KTx`
+ * @param   output           The output size, in bits
+ * @param   msg              The message to digest
+ * @param   msglen           The length of the message, in bytes
+ * @param   custom           The customisation string
+ * @param   customlen        The length of the customisation string, in bytes
+ * @param   pool             The worker pool, may be `NULL`
+ * @param   step             The number of bytes to feed to each call of
+ *                           `libkeccak_k12_update`, 0 to pass the entire
+ *                           message to `libkeccak_k12_digest`
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_k12_case(long int semicapacity, long int output, const char *restrict msg, size_t msglen,
+              const char *restrict custom, size_t customlen, struct libkeccak_worker_pool *pool,
+              size_t step, const char *restrict expected_answer)
+{
+	struct libkeccak_k12_state state;
+	unsigned char hashsum[64];
+	char hexsum[64 * 2 + 1];
+	size_t n;
+	int ok;
+
+	if (libkeccak_k12_initialise(&state, semicapacity, output, pool)) {
+		perror("libkeccak_k12_initialise");
+		return -1;
+	}
+
+	for (; step && msglen; msg = &msg[n], msglen -= n) {
+		n = msglen < step ? msglen : step;
+		if (libkeccak_k12_update(&state, msg, n)) {
+			perror("libkeccak_k12_update");
+			goto fail;
+		}
+	}
+
+	if (libkeccak_k12_digest(&state, msglen ? msg : NULL, msglen, custom, customlen, hashsum)) {
+		perror("libkeccak_k12_digest");
+		goto fail;
+	}
+
+	libkeccak_behex_lower(hexsum, hashsum, (size_t)((output + 7) / 8));
+	ok = !strcmp(hexsum, expected_answer);
+	printf("%s%s\n", ok ? "OK" : "Fail: ", ok ? "" : hexsum);
+
+	libkeccak_k12_destroy(&state);
+	return ok - 1;
+
+fail:
+	libkeccak_k12_destroy(&state);
+	return -1;
+}
+
+
+/**
+ * Test KangarooTwelve
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_k12(void)
+{
+#define k12(semicapacity, output, message, length, custom, customlen)\
+	(printf("  Testing KT%i(%s, %s, %i): ", semicapacity, #message, #custom, output),\
+	 test_k12_case(semicapacity, output, message, length, custom, customlen, NULL, 0, answer))
+
+#define k12_stream(semicapacity, output, message, length, custom, customlen, pool, step)\
+	(printf("  Testing KT%i(%s, %s, %i) with %s in steps of %zu bytes: ",\
+	        semicapacity, #message, #custom, output, pool ? "a worker pool" : "one thread", (size_t)(step)),\
+	 test_k12_case(semicapacity, output, message, length, custom, customlen, pool, step, answer))
+
+	static const size_t steps[] = {1000, 8192, 8193, 100000, 1 << 20};
+	static char ptn[1419857];
+	struct libkeccak_worker_pool *pool;
+	struct libkeccak_k12_state state;
+	unsigned char hashsum[32];
+	char hexsum[32 * 2 + 1];
+	const char *answer;
+	FILE *f;
+	size_t i;
+	int fd;
+
+	printf("Testing KangarooTwelve:\n");
+
+	for (i = 0; i < sizeof(ptn); i++)
+		ptn[i] = (char)(i % 251);
+
+	answer = "1ac2d450fc3b4205d19da7bfca1b37513c0803577ac7167f06fe2ce1f0ef39e5";
+	if (k12(128, 256, "", 0, "", 0))
+		return -1;
+
+	answer = "1ac2d450fc3b4205d19da7bfca1b37513c0803577ac7167f06fe2ce1f0ef39e5"
+	         "4269c056b8c82e48276038b6d292966cc07a3d4645272e31ff38508139eb0a71";
+	if (k12(128, 512, "", 0, "", 0))
+		return -1;
+
+	answer = "2bda92450e8b147f8a7cb629e784a058efca7cf7d8218e02d345dfaa65244a1f";
+	if (k12(128, 256, ptn, 1, "", 0))
+		return -1;
+
+	answer = "6bf75fa2239198db4772e36478f8e19b0f371205f6a9a93a273f51df37122888";
+	if (k12(128, 256, ptn, 17, "", 0))
+		return -1;
+
+	answer = "0c315ebcdedbf61426de7dcf8fb725d1e74675d7f5327a5067f367b108ecb67c";
+	if (k12(128, 256, ptn, 289, "", 0))
+		return -1;
+
+	answer = "cb552e2ec77d9910701d578b457ddf772c12e322e4ee7fe417f92c758f0d59d0";
+	if (k12(128, 256, ptn, 4913, "", 0))
+		return -1;
+
+	answer = "8701045e22205345ff4dda05555cbb5c3af1a771c2b89baef37db43d9998b9fe";
+	if (k12(128, 256, ptn, 83521, "", 0))
+		return -1;
+
+	answer = "844d610933b1b9963cbdeb5ae3b6b05cc7cbd67ceedf883eb678a0a8e0371682";
+	if (k12(128, 256, ptn, 1419857, "", 0))
+		return -1;
+
+	answer = "fab658db63e94a246188bf7af69a133045f46ee984c56e3c3328caaf1aa1a583";
+	if (k12(128, 256, "", 0, ptn, 1))
+		return -1;
+
+	answer = "d61d5c064508ce4b120f6d86b8b3d41e516b7e619564fe8fa4f9d7d0d081942f";
+	if (k12(128, 256, "", 0, ptn, 68921))
+		return -1;
+
+	answer = "75d2f86a2e644566726b4fbcfc5657b9dbcf070c7b0dca06450ab291d7443bcf";
+	if (k12(128, 256, "\xff\xff\xff\xff\xff\xff\xff", 7, ptn, 68921))
+		return -1;
+
+	answer = "48f256f6772f9edfb6a8b661ec92dc93b95ebd05a08a17b39ae3490870c926c3";
+	if (k12(128, 256, ptn, 8192, "", 0))
+		return -1;
+
+	answer = "7b4437c8b64025f32868378499739d054ebeb18cf9a93ab3c3e2aafe793b90c8";
+	if (k12(128, 256, ptn, 8192, ptn, 1))
+		return -1;
+
+	answer = "b23d2e9cea9f4904e02bec06817fc10ce38ce8e93ef4c89e6537076af8646404"
+	         "e3e8b68107b8833a5d30490aa33482353fd4adc7148ecb782855003aaebde4a9";
+	if (k12(256, 512, "", 0, "", 0))
+		return -1;
+
+	answer = "b06275d284cd1cf205bcbe57dccd3ec1ff6686e3ed15776383e1f2fa3c6ac8f0"
+	         "8bf8a162829db1a44b2a43ff83dd89c3cf1ceb61ede659766d5ccf817a62ba8d";
+	if (k12(256, 512, ptn, 83521, "", 0))
+		return -1;
+
+	pool = libkeccak_worker_pool_create(4);
+	if (!pool) {
+		perror("libkeccak_worker_pool_create");
+		return -1;
+	}
+
+	answer = "844d610933b1b9963cbdeb5ae3b6b05cc7cbd67ceedf883eb678a0a8e0371682";
+	if (k12_stream(128, 256, ptn, 1419857, "", 0, pool, 0))
+		goto fail;
+	for (i = 0; i < sizeof(steps) / sizeof(*steps); i++)
+		if (k12_stream(128, 256, ptn, 1419857, "", 0, NULL, steps[i]) ||
+		    k12_stream(128, 256, ptn, 1419857, "", 0, pool, steps[i]))
+			goto fail;
+
+	answer = "b0d695c8fb12c515e45b6955f3adab8087769d84e54149b0f9173c464c65d398";
+	if (k12_stream(128, 256, ptn, 200000, ptn, 3, NULL, 8191) ||
+	    k12_stream(128, 256, ptn, 200000, ptn, 3, pool, 8191))
+		goto fail;
+
+	answer = "b06275d284cd1cf205bcbe57dccd3ec1ff6686e3ed15776383e1f2fa3c6ac8f0"
+	         "8bf8a162829db1a44b2a43ff83dd89c3cf1ceb61ede659766d5ccf817a62ba8d";
+	if (k12_stream(256, 512, ptn, 83521, "", 0, pool, 333))
+		goto fail;
+
+	printf("  Testing libkeccak_k12sum_fd: ");
+	f = tmpfile();
+	if (!f || fwrite(ptn, 1, sizeof(ptn), f) != sizeof(ptn) || fflush(f)) {
+		perror("tmpfile");
+		goto fail;
+	}
+	fd = fileno(f);
+	if (lseek(fd, 0, SEEK_SET) || libkeccak_k12sum_fd(fd, &state, 128, 256, pool, "", 0, hashsum)) {
+		perror("libkeccak_k12sum_fd");
+		fclose(f);
+		goto fail;
+	}
+	fclose(f);
+	libkeccak_k12_destroy(&state);
+	libkeccak_behex_lower(hexsum, hashsum, sizeof(hashsum));
+	answer = "844d610933b1b9963cbdeb5ae3b6b05cc7cbd67ceedf883eb678a0a8e0371682";
+	if (strcmp(hexsum, answer)) {
+		printf("Fail: %s\n", hexsum);
+		goto fail;
+	}
+	printf("OK\n");
+
+	libkeccak_worker_pool_free(pool);
+	printf("\n");
+	return 0;
+
+fail:
+	libkeccak_worker_pool_free(pool);
+	return -1;
+
+#undef k12
+#undef k12_stream
+}
+
+
+/**
+ * Run a test case for ParallelHash
+ * 
+ * @param   semicapacity     The value of x in `ParallelHashx`
+ * @param   output           The output size, in bits
+ * @param   blocksize        The block size, in bytes
+ * @param   msg              The message to digest
+ * @param   msglen           The length of the message, in bytes
+ * @param   custom           The customisation string
+ * @param   xof              Whether to use ParallelHashXOF
+ * @param   pool             The worker pool, may be `NULL`
+ * @param   step             The number of bytes to feed to each call of
+ *                           `libkeccak_parallelhash_update`, 0 to pass the
+ *                           entire message to `libkeccak_parallelhash_digest`
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_parallelhash_case(long int semicapacity, long int output, size_t blocksize, const char *restrict msg, size_t msglen,
+                       const char *restrict custom, int xof, struct libkeccak_worker_pool *pool,
+                       size_t step, const char *restrict expected_answer)
+{
+	struct libkeccak_parallelhash_state state;
+	unsigned char hashsum[64];
+	char hexsum[64 * 2 + 1];
+	size_t n;
+	int ok;
+
+	if (libkeccak_parallelhash_initialise(&state, semicapacity, output, blocksize, custom, strlen(custom), pool)) {
+		perror("libkeccak_parallelhash_initialise");
+		return -1;
+	}
+
+	for (; step && msglen; msg = &msg[n], msglen -= n) {
+		n = msglen < step ? msglen : step;
+		if (libkeccak_parallelhash_update(&state, msg, n)) {
+			perror("libkeccak_parallelhash_update");
+			goto fail;
+		}
+	}
+
+	if (libkeccak_parallelhash_digest(&state, msglen ? msg : NULL, msglen, xof, hashsum)) {
+		perror("libkeccak_parallelhash_digest");
+		goto fail;
+	}
+
+	libkeccak_behex_lower(hexsum, hashsum, (size_t)((output + 7) / 8));
+	ok = !strcmp(hexsum, expected_answer);
+	printf("%s%s\n", ok ? "OK" : "Fail: ", ok ? "" : hexsum);
+
+	libkeccak_parallelhash_destroy(&state);
+	return ok - 1;
+
+fail:
+	libkeccak_parallelhash_destroy(&state);
+	return -1;
+}
+
+
+/**
+ * Test ParallelHash
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_parallelhash(void)
+{
+#define parallelhash(semicapacity, output, blocksize, message, length, custom, xof, pool, step)\
+	(printf("  Testing ParallelHash%s%i(%s, %i, %i, \"%s\") with %s in steps of %zu bytes: ",\
+	        xof ? "XOF" : "", semicapacity, #message, blocksize, output, custom,\
+	        pool ? "a worker pool" : "one thread", (size_t)(step)),\
+	 test_parallelhash_case(semicapacity, output, blocksize, message, length, custom, xof, pool, step, answer))
+
+	static const char sample[] = "\x00\x01\x02\x03\x04\x05\x06\x07\x10\x11\x12\x13\x14\x15\x16\x17"
+	                             "\x20\x21\x22\x23\x24\x25\x26\x27";
+	static char ptn[1000000];
+	struct libkeccak_parallelhash_state state;
+	struct libkeccak_worker_pool *pool;
+	const char *answer;
+	size_t i;
+
+	printf("Testing ParallelHash:\n");
+
+	for (i = 0; i < sizeof(ptn); i++)
+		ptn[i] = (char)(i % 251);
+
+	pool = libkeccak_worker_pool_create(3);
+	if (!pool) {
+		perror("libkeccak_worker_pool_create");
+		return -1;
+	}
+
+	answer = "ba8dc1d1d979331d3f813603c67f72609ab5e44b94a0b8f9af46514454a2b4f5";
+	if (parallelhash(128, 256, 8, sample, 24, "", 0, NULL, 0) ||
+	    parallelhash(128, 256, 8, sample, 24, "", 0, pool, 5))
+		goto fail;
+
+	answer = "fc484dcb3f84dceedc353438151bee58157d6efed0445a81f165e495795b7206";
+	if (parallelhash(128, 256, 8, sample, 24, "Parallel Data", 0, NULL, 0))
+		goto fail;
+
+	answer = "bc1ef124da34495e948ead207dd9842235da432d2bbc54b4c110e64c45110553"
+	         "1b7f2a3e0ce055c02805e7c2de1fb746af97a1dd01f43b824e31b87612410429";
+	if (parallelhash(256, 512, 8, sample, 24, "", 0, NULL, 0))
+		goto fail;
+
+	answer = "cdf15289b54f6212b4bc270528b49526006dd9b54e2b6add1ef6900dda3963bb"
+	         "33a72491f236969ca8afaea29c682d47a393c065b38e29fae651a2091c833110";
+	if (parallelhash(256, 512, 8, sample, 24, "Parallel Data", 0, pool, 0))
+		goto fail;
+
+	answer = "fe47d661e49ffe5b7d999922c062356750caf552985b8e8ce6667f2727c3c8d3";
+	if (parallelhash(128, 256, 8, sample, 24, "", 1, NULL, 0))
+		goto fail;
+
+	answer = "538e105f1a22f44ed2f5cc1674fbd40be803d9c99bf5f8d90a2c8193f3fe6ea7"
+	         "68e5c1a20987e2c9c65febed03887a51d35624ed12377594b5585541dc377efc";
+	if (parallelhash(256, 512, 8, sample, 24, "Parallel Data", 1, NULL, 0))
+		goto fail;
+
+	answer = "471d988fee963ed2055ad842640176e2410aee74398549d6fcb2411389797337";
+	if (parallelhash(128, 256, 64, "", 0, "", 0, NULL, 0))
+		goto fail;
+
+	answer = "0c6e40c6581c0dd85426fbc7a5640743052df655caffa19453fbc157f9db71bc";
+	if (parallelhash(128, 256, 1000, ptn, 100000, "abc", 0, NULL, 0) ||
+	    parallelhash(128, 256, 1000, ptn, 100000, "abc", 0, pool, 0) ||
+	    parallelhash(128, 256, 1000, ptn, 100000, "abc", 0, NULL, 999) ||
+	    parallelhash(128, 256, 1000, ptn, 100000, "abc", 0, pool, 4096) ||
+	    parallelhash(128, 256, 1000, ptn, 100000, "abc", 0, pool, 60000))
+		goto fail;
+
+	answer = "e9c6ac5adc54e494b6c3226018d4a2ebfe2c94d0e9bcab43697a2bf1cdf2845b"
+	         "d823488d35536f06963bdf7b14ddd3f6d158cc6c626afecac189a55f026130eb";
+	if (parallelhash(256, 512, 8192, ptn, 30000, "", 1, NULL, 0) ||
+	    parallelhash(256, 512, 8192, ptn, 30000, "", 1, pool, 7))
+		goto fail;
+
+	answer = "b13218728492fb56f4af374b0147ca16496a2bd77c0fe4b64a7da6bb924181f8";
+	if (parallelhash(128, 256, 1, ptn, 777, "", 0, NULL, 0) ||
+	    parallelhash(128, 256, 1, ptn, 777, "", 0, pool, 100))
+		goto fail;
+
+	answer = "1946943cc3a1c3bdb07f0e4cbb83378f2750d45ae67d1eb4aa46f8dc38c3a752";
+	if (parallelhash(128, 256, 300000, ptn, 1000000, "abc", 0, NULL, 0) ||
+	    parallelhash(128, 256, 300000, ptn, 1000000, "abc", 0, pool, 0) ||
+	    parallelhash(128, 256, 300000, ptn, 1000000, "abc", 0, NULL, 123457) ||
+	    parallelhash(128, 256, 300000, ptn, 1000000, "abc", 0, pool, 700001))
+		goto fail;
+
+	answer = "b7f8cee96154398976a3562a43a853bb1bcac888128cd3906c8b67d32604278b"
+	         "8ec88bcb228d2ffba3b24faaf5a78a53b06b774e53bc6f58a2355c7c6e34e45c";
+	if (parallelhash(256, 512, 350000, ptn, 700000, "", 1, pool, 0) ||
+	    parallelhash(256, 512, 350000, ptn, 700000, "", 1, NULL, 350000) ||
+	    parallelhash(256, 512, 350000, ptn, 700000, "", 1, pool, 99999))
+		goto fail;
+
+	printf("  Testing that oversized blocks are rejected: ");
+	if ((errno = 0, libkeccak_parallelhash_initialise(&state, 128, 256, SIZE_MAX / 2 + 1, NULL, 0, pool) != -1) ||
+	    errno != EINVAL) {
+		printf("Fail\n");
+		goto fail;
+	}
+	if (libkeccak_parallelhash_initialise(&state, 128, 256, SIZE_MAX / 4, NULL, 0, pool)) {
+		perror("libkeccak_parallelhash_initialise");
+		goto fail;
+	}
+	libkeccak_parallelhash_destroy(&state);
+	printf("OK\n");
+
+	libkeccak_worker_pool_free(pool);
+	printf("\n");
+	return 0;
+
+fail:
+	libkeccak_worker_pool_free(pool);
+	return -1;
+
+#undef parallelhash
+}
+
+
+/**
+ * Run a test case for KMAC
+ * 
+ * @param   state            The hashing state, with the key absorbed
+ * @param   msg              The message to digest
+ * @param   msglen           The length of the message, in bytes
+ * @param   xof              Whether to use KMACXOF
+ * @param   step             The number of bytes to feed to each call of
+ *                           `libkeccak_kmac_update`, 0 to pass the
+ *                           entire message to `libkeccak_kmac_digest`
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_kmac_case(struct libkeccak_kmac_state *restrict state, const char *restrict msg, size_t msglen, int xof,
+               size_t step, const char *restrict expected_answer)
+{
+	unsigned char hashsum[64];
+	char hexsum[64 * 2 + 1];
+	size_t n;
+	int ok;
+
+	libkeccak_kmac_reset(state);
+
+	for (; step && msglen; msg = &msg[n], msglen -= n) {
+		n = msglen < step ? msglen : step;
+		if (libkeccak_kmac_update(state, msg, n)) {
+			perror("libkeccak_kmac_update");
+			return -1;
+		}
+	}
+
+	if (libkeccak_kmac_digest(state, msglen ? msg : NULL, msglen, xof, hashsum)) {
+		perror("libkeccak_kmac_digest");
+		return -1;
+	}
+
+	libkeccak_behex_lower(hexsum, hashsum, (size_t)((state->sponge.n + 7) / 8));
+	ok = !strcmp(hexsum, expected_answer);
+	printf("%s%s\n", ok ? "OK" : "Fail: ", ok ? "" : hexsum);
+	return ok - 1;
+}
+
+
+/**
+ * Test KMAC
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_kmac(void)
+{
+#define kmac(semicapacity, output, key, keylen, custom)\
+	(printf("  Testing KMAC%i(%s, \"%s\", %i):\n", semicapacity, #key, custom, output),\
+	 libkeccak_kmac_initialise(&state, semicapacity, output, key, keylen, custom, strlen(custom)))
+
+#define kmac_msg(message, length, xof, step)\
+	(printf("    with %s%s in steps of %zu bytes: ", #message, xof ? " as XOF" : "", (size_t)(step)),\
+	 test_kmac_case(&state, message, length, xof, step, answer))
+
+	struct libkeccak_kmac_state state;
+	const char *answer;
+	char key[300], msg[1000];
+	size_t i;
+
+	printf("Testing KMAC:\n");
+
+	for (i = 0; i < sizeof(msg); i++)
+		msg[i] = (char)(i % 251);
+	for (i = 0; i < 32; i++)
+		key[i] = (char)(0x40 + i);
+
+	if (kmac(128, 256, key, 32, "")) {
+		perror("libkeccak_kmac_initialise");
+		return -1;
+	}
+	answer = "e5780b0d3ea6f7d3a429c5706aa43a00fadbd7d49628839e3187243f456ee14e";
+	if (kmac_msg(msg, 4, 0, 0))
+		goto fail;
+	answer = "cd83740bbd92ccc8cf032b1481a0f4460e7ca9dd12b08a0c4031178bacd6ec35";
+	if (kmac_msg(msg, 4, 1, 0))
+		goto fail;
+	answer = "e5780b0d3ea6f7d3a429c5706aa43a00fadbd7d49628839e3187243f456ee14e";
+	if (kmac_msg(msg, 4, 0, 1))
+		goto fail;
+	libkeccak_kmac_destroy(&state);
+
+	if (kmac(128, 256, key, 32, "My Tagged Application")) {
+		perror("libkeccak_kmac_initialise");
+		return -1;
+	}
+	answer = "3b1fba963cd8b0b59e8c1a6d71888b7143651af8ba0a7070c0979e2811324aa5";
+	if (kmac_msg(msg, 4, 0, 0))
+		goto fail;
+	answer = "1f5b4e6cca02209e0dcb5ca635b89a15e271ecc760071dfd805faa38f9729230";
+	if (kmac_msg(msg, 200, 0, 0) ||
+	    kmac_msg(msg, 200, 0, 7))
+		goto fail;
+	libkeccak_kmac_destroy(&state);
+
+	if (kmac(256, 512, key, 32, "My Tagged Application")) {
+		perror("libkeccak_kmac_initialise");
+		return -1;
+	}
+	answer = "20c570c31346f703c9ac36c61c03cb64c3970d0cfc787e9b79599d273a68d2f7"
+	         "f69d4cc3de9d104a351689f27cf6f5951f0103f33f4f24871024d9c27773a8dd";
+	if (kmac_msg(msg, 4, 0, 0))
+		goto fail;
+	answer = "d5be731c954ed7732846bb59dbe3a8e30f83e77a4bff4459f2f1c2b4ecebb8ce"
+	         "67ba01c62e8ab8578d2d499bd1bb276768781190020a306a97de281dcc30305d";
+	if (kmac_msg(msg, 200, 1, 0))
+		goto fail;
+	libkeccak_kmac_destroy(&state);
+
+	if (kmac(256, 512, key, 32, "")) {
+		perror("libkeccak_kmac_initialise");
+		return -1;
+	}
+	answer = "75358cf39e41494e949707927cee0af20a3ff553904c86b08f21cc414bcfd691"
+	         "589d27cf5e15369cbbff8b9a4c2eb17800855d0235ff635da82533ec6b759b69";
+	if (kmac_msg(msg, 200, 0, 0))
+		goto fail;
+	libkeccak_kmac_destroy(&state);
+
+	if (kmac(128, 256, NULL, 0, "")) {
+		perror("libkeccak_kmac_initialise");
+		return -1;
+	}
+	answer = "5c135c615152fb4d9784dd1155f9b6034e013fd77165c327dfa4d36701983ef7";
+	if (kmac_msg(NULL, 0, 0, 0))
+		goto fail;
+	libkeccak_kmac_destroy(&state);
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = (char)(i % 251);
+	if (kmac(128, 256, key, 300, "x")) {
+		perror("libkeccak_kmac_initialise");
+		return -1;
+	}
+	answer = "3532c36e23e619026b36628924e0f707e00614db7b5b65dfb6b02aac3855e028";
+	if (kmac_msg(msg, 1000, 0, 0) ||
+	    kmac_msg(msg, 1000, 0, 168))
+		goto fail;
+	libkeccak_kmac_destroy(&state);
+
+	printf("\n");
+	return 0;
+
+fail:
+	libkeccak_kmac_destroy(&state);
+	return -1;
+
+#undef kmac
+#undef kmac_msg
+}
+
+
+/**
+ * Run a test case for TupleHash
+ * 
+ * @param   semicapacity     The value of x in `TupleHashx`
+ * @param   output           The output size, in bits
+ * @param   custom           The customisation string
+ * @param   fields           The fields of the tuple
+ * @param   nfields          The number of fields in the tuple
+ * @param   xof              Whether to use TupleHashXOF
+ * @param   split            The number of fields to pass to
+ *                           `libkeccak_tuplehash_update`, the rest
+ *                           are passed to `libkeccak_tuplehash_digest`
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_tuplehash_case(long int semicapacity, long int output, const char *restrict custom,
+                    const struct libkeccak_tuple_field *restrict fields, size_t nfields, int xof,
+                    size_t split, const char *restrict expected_answer)
+{
+	struct libkeccak_state state;
+	unsigned char hashsum[64];
+	char hexsum[64 * 2 + 1];
+	int ok;
+
+	printf("  Testing TupleHash%s%li(%zu fields, %li, \"%s\") with %zu fields updated: ",
+	       xof ? "XOF" : "", semicapacity, nfields, output, custom, split);
+
+	if (libkeccak_tuplehash_initialise(&state, semicapacity, output, custom, strlen(custom))) {
+		perror("libkeccak_tuplehash_initialise");
+		return -1;
+	}
+
+	if (libkeccak_tuplehash_update(&state, fields, split)) {
+		perror("libkeccak_tuplehash_update");
+		goto fail;
+	}
+
+	if (libkeccak_tuplehash_digest(&state, &fields[split], nfields - split, xof, hashsum)) {
+		perror("libkeccak_tuplehash_digest");
+		goto fail;
+	}
+
+	libkeccak_behex_lower(hexsum, hashsum, (size_t)((output + 7) / 8));
+	ok = !strcmp(hexsum, expected_answer);
+	printf("%s%s\n", ok ? "OK" : "Fail: ", ok ? "" : hexsum);
+	libkeccak_state_destroy(&state);
+	return ok - 1;
+
+fail:
+	libkeccak_state_destroy(&state);
+	return -1;
+}
+
+
+/**
+ * Test TupleHash
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_tuplehash(void)
+{
+#define tuplehash(semicapacity, output, custom, nfields, xof, split)\
+	test_tuplehash_case(semicapacity, output, custom, fields, nfields, xof, split, answer)
+
+	struct libkeccak_tuple_field fields[4];
+	char data[1000];
+	size_t i;
+	const char *answer;
+
+	printf("Testing TupleHash:\n");
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = (char)(i % 251);
+	fields[0].data = "\x00\x01\x02";
+	fields[0].len = 3;
+	fields[1].data = "\x10\x11\x12\x13\x14\x15";
+	fields[1].len = 6;
+	fields[2].data = "\x20\x21\x22\x23\x24\x25\x26\x27\x28";
+	fields[2].len = 9;
+
+	answer = "c5d8786c1afb9b82111ab34b65b2c0048fa64e6d48e263264ce1707d3ffc8ed1";
+	if (tuplehash(128, 256, "", 2, 0, 0) ||
+	    tuplehash(128, 256, "", 2, 0, 1) ||
+	    tuplehash(128, 256, "", 2, 0, 2))
+		return -1;
+	answer = "75cdb20ff4db1154e841d758e24160c54bae86eb8c13e7f5f40eb35588e96dfb";
+	if (tuplehash(128, 256, "My Tuple App", 2, 0, 0))
+		return -1;
+	answer = "e60f202c89a2631eda8d4c588ca5fd07f39e5151998deccf973adb3804bb6e84";
+	if (tuplehash(128, 256, "My Tuple App", 3, 0, 1))
+		return -1;
+	answer = "cfb7058caca5e668f81a12a20a2195ce97a925f1dba3e7449a56f82201ec6073"
+	         "11ac2696b1ab5ea2352df1423bde7bd4bb78c9aed1a853c78672f9eb23bbe194";
+	if (tuplehash(256, 512, "", 2, 0, 0))
+		return -1;
+	answer = "45000be63f9b6bfd89f54717670f69a9bc763591a4f05c50d68891a744bcc6e7"
+	         "d6d5b5e82c018da999ed35b0bb49c9678e526abd8e85c13ed254021db9e790ce";
+	if (tuplehash(256, 512, "My Tuple App", 3, 0, 2))
+		return -1;
+	answer = "2f103cd7c32320353495c68de1a8129245c6325f6f2a3d608d92179c96e68488";
+	if (tuplehash(128, 256, "", 2, 1, 0))
+		return -1;
+	answer = "0c59b11464f2336c34663ed51b2b950bec743610856f36c28d1d088d8a244628"
+	         "4dd09830a6a178dc752376199fae935d86cfdee5913d4922dfd369b66a53c897";
+	if (tuplehash(256, 512, "My Tuple App", 3, 1, 3))
+		return -1;
+	answer = "786aa3d4fcaadf0aa723a4818a1a72de2330d613e5de7ae4eb6cb4cdd26adba2";
+	if (tuplehash(128, 256, "", 0, 0, 0))
+		return -1;
+
+	fields[0].data = NULL;
+	fields[0].len = 0;
+	fields[1].data = data;
+	fields[1].len = 1000;
+	fields[2].data = NULL;
+	fields[2].len = 0;
+	fields[3].data = data;
+	fields[3].len = 5;
+	answer = "d4a5a5c54a53304da74f5add701b1d43faa747064446f823af6a40d239c2783a";
+	if (tuplehash(128, 256, "", 4, 0, 0) ||
+	    tuplehash(128, 256, "", 4, 0, 2))
+		return -1;
+
+	return 0;
+
+#undef tuplehash
+}
+
+/**
+ * Run a test case for `libkeccak_cshake_prefix_load`
+ * 
+ * @param   state            The state to hash the message in
+ * @param   prefix           The sponge with the initialisation blocks absorbed
+ * @param   msg              The message to digest
+ * @param   msglen           The length of the message, in bytes
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_cshake_prefix_case(struct libkeccak_state *restrict state, const struct libkeccak_cshake_prefix *restrict prefix,
+                        const void *restrict msg, size_t msglen, const char *restrict expected_answer)
+{
+	unsigned char hashsum[64];
+	char hexsum[64 * 2 + 1];
+	int ok;
+
+	libkeccak_cshake_prefix_load(state, prefix);
+	if (libkeccak_digest(state, msg, msglen, 0, prefix->suffix, hashsum)) {
+		perror("libkeccak_digest");
+		return -1;
+	}
+
+	libkeccak_behex_lower(hexsum, hashsum, (size_t)((prefix->state.n + 7) / 8));
+	ok = !strcmp(hexsum, expected_answer);
+	printf("%s%s\n", ok ? "OK" : "Fail: ", ok ? "" : hexsum);
+	return ok - 1;
+}
+
+
+/**
+ * Test `libkeccak_cshake_prefix_initialise`,
+ * `libkeccak_cshake_prefix_load`, and
+ * `libkeccak_cshakesum_fd`
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_cshake_prefix(void)
+{
+#define cshake_prefix(semicapacity, output, s)\
+	(printf("  Testing cSHAKE%i(, %i, \"\", \"%s\"):\n", semicapacity, output, s),\
+	 libkeccak_spec_cshake(&spec, semicapacity, output),\
+	 libkeccak_cshake_prefix_initialise(&prefix, &spec, NULL, 0, 0, NULL, s, strlen(s), 0, NULL))
+
+#define cshake_msg(message, length)\
+	(printf("    with %s: ", #message),\
+	 test_cshake_prefix_case(&state, &prefix, message, length, answer))
+
+	struct libkeccak_spec spec;
+	struct libkeccak_cshake_prefix prefix;
+	struct libkeccak_state state;
+	unsigned char seq[200], hashsum[64];
+	char hexsum[64 * 2 + 1];
+	const char *answer;
+	FILE *f;
+	size_t i;
+	int fd;
+
+	printf("Testing cSHAKE with prepared initialisation blocks:\n");
+
+	for (i = 0; i < sizeof(seq); i++)
+		seq[i] = (unsigned char)i;
+
+	if (cshake_prefix(128, 256, "Email Signature")) {
+		perror("libkeccak_cshake_prefix_initialise");
+		return -1;
+	}
+	answer = "c1c36925b6409a04f1b504fcbca9d82b4017277cb5ed2b2065fc1d3814d5aaf5";
+	if (cshake_msg(seq, 4))
+		goto fail;
+	answer = "c5221d50e4f822d96a2e8881a961420f294b7b24fe3d2094baed2c6524cc166b";
+	if (cshake_msg(seq, 200))
+		goto fail;
+	answer = "c1c36925b6409a04f1b504fcbca9d82b4017277cb5ed2b2065fc1d3814d5aaf5";
+	if (cshake_msg(seq, 4))
+		goto fail;
+	libkeccak_cshake_prefix_destroy(&prefix);
+
+	if (cshake_prefix(256, 512, "Email Signature")) {
+		perror("libkeccak_cshake_prefix_initialise");
+		return -1;
+	}
+	answer = "d008828e2b80ac9d2218ffee1d070c48b8e4c87bff32c9699d5b6896eee0edd1"
+	         "64020e2be0560858d9c00c037e34a96937c561a74c412bb4c746469527281c8c";
+	if (cshake_msg(seq, 4))
+		goto fail;
+
+	printf("  Testing libkeccak_cshakesum_fd: ");
+	f = tmpfile();
+	if (!f || fwrite(seq, 1, sizeof(seq), f) != sizeof(seq) || fflush(f)) {
+		perror("tmpfile");
+		goto fail;
+	}
+	fd = fileno(f);
+	if (lseek(fd, 0, SEEK_SET) || libkeccak_cshakesum_fd(fd, &state, &prefix, hashsum)) {
+		perror("libkeccak_cshakesum_fd");
+		fclose(f);
+		goto fail;
+	}
+	fclose(f);
+	libkeccak_behex_lower(hexsum, hashsum, sizeof(hashsum));
+	answer = "07dc27b11e51fbac75bc7b3c1d983e8b4b85fb1defaf218912ac864302730917"
+	         "27f42b17ed1df63e8ec118f04b23633c1dfb1574c8fb55cb45da8e25afb092bb";
+	if (strcmp(hexsum, answer)) {
+		printf("Fail: %s\n", hexsum);
+		goto fail;
+	}
+	printf("OK\n");
+	libkeccak_cshake_prefix_destroy(&prefix);
+
+	if (cshake_prefix(128, 256, "")) {
+		perror("libkeccak_cshake_prefix_initialise");
+		return -1;
+	}
+	if (strcmp(prefix.suffix, LIBKECCAK_SHAKE_SUFFIX)) {
+		printf("  Fail: cSHAKE without strings does not use the SHAKE suffix\n");
+		goto fail;
+	}
+	answer = "7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26";
+	if (cshake_msg("", 0))
+		goto fail;
+	libkeccak_cshake_prefix_destroy(&prefix);
+
+	libkeccak_state_destroy(&state);
+	printf("\n");
+	return 0;
+
+fail:
+	libkeccak_cshake_prefix_destroy(&prefix);
+	libkeccak_state_destroy(&state);
+	return -1;
+
+#undef cshake_prefix
+#undef cshake_msg
+}
+
+/**
+ * Run a test case for HMAC
+ * 
+ * @param   name             The name of the hash function
+ * @param   spec             The specifications for the hash function
+ * @param   suffix           The message suffix for the hash function
+ * @param   key              The key
+ * @param   keylen           The length of the key, in bits
+ * @param   msg              The message to digest
+ * @param   msglen           The length of the message, in whole bytes
+ * @param   bits             The number of bits at the end of the message
+ *                           not covered by `msglen`
+ * @param   step             The number of bytes to feed to each call of
+ *                           `libkeccak_hmac_update`, 0 to pass the entire
+ *                           message to `libkeccak_hmac_digest`
+ * @param   expected_answer  The expected answer, must be lowercase
+ * @return                   Zero on success, -1 on error
+ */
+static int
+test_hmac_case(const char *restrict name, const struct libkeccak_spec *restrict spec, const char *restrict suffix,
+               const void *restrict key, size_t keylen, const char *restrict msg, size_t msglen,
+               size_t bits, size_t step, const char *restrict expected_answer)
+{
+	struct libkeccak_hmac_state state, copy;
+	unsigned char hashsum[256];
+	char hexsum[256 * 2 + 1];
+	unsigned char *marshalled = NULL;
+	const char *rest;
+	size_t n, left;
+	int ok, round;
+
+	printf("  Testing HMAC-%s with %zu-bit key on %zu bits in steps of %zu bytes: ",
+	       name, keylen, msglen * 8 + bits, step);
+
+	if (libkeccak_hmac_initialise(&state, spec, key, keylen)) {
+		perror("libkeccak_hmac_initialise");
+		return -1;
+	}
+
+	/* The second round reuses the precomputed key
+	 * states, and is marshalled in the middle */
+	for (round = 0; round < 2; round++) {
+		rest = msg;
+		left = msglen;
+		for (; step && left; rest = &rest[n], left -= n) {
+			n = left < step ? left : step;
+			if (libkeccak_hmac_update(&state, rest, n)) {
+				perror("libkeccak_hmac_update");
+				goto fail;
+			}
+			if (round && left <= msglen / 2 + n && !marshalled) {
+				marshalled = malloc(libkeccak_hmac_marshal(&state, NULL));
+				if (!marshalled) {
+					perror("malloc");
+					goto fail;
+				}
+				libkeccak_hmac_marshal(&state, marshalled);
+				libkeccak_hmac_destroy(&state);
+				if (!libkeccak_hmac_unmarshal(&state, marshalled)) {
+					perror("libkeccak_hmac_unmarshal");
+					free(marshalled);
+					return -1;
+				}
+				free(marshalled);
+			}
+		}
+
+		if (round) {
+			if (libkeccak_hmac_copy(&copy, &state)) {
+				perror("libkeccak_hmac_copy");
+				goto fail;
+			}
+			libkeccak_hmac_destroy(&state);
+			state = copy;
+		}
+
+		if (libkeccak_hmac_digest(&state, left || bits ? rest : NULL, left, bits, suffix, hashsum)) {
+			perror("libkeccak_hmac_digest");
+			goto fail;
+		}
+
+		libkeccak_behex_lower(hexsum, hashsum, (size_t)((spec->output + 7) / 8));
+		ok = !strcmp(hexsum, expected_answer);
+		if (!ok) {
+			printf("Fail: %s\n", hexsum);
+			goto fail;
+		}
+
+		if (libkeccak_hmac_reset(&state, NULL, 0)) {
+			perror("libkeccak_hmac_reset");
+			goto fail;
+		}
+	}
+
+	libkeccak_hmac_destroy(&state);
+	printf("OK\n");
+	return 0;
+
+fail:
+	libkeccak_hmac_destroy(&state);
+	return -1;
+}
+
+
+/**
+ * Test HMAC
+ * 
+ * @return  Zero on success, -1 on error
+ */
+static int
+test_hmac(void)
+{
+#define hmac(output, keylen, msglen, bits, step)\
+	(libkeccak_spec_sha3(&spec, output),\
+	 test_hmac_case("SHA3-"#output, &spec, LIBKECCAK_SHA3_SUFFIX, key, keylen, msg, msglen, bits, step, answer))
+
+#define hmac_shake(semicapacity, output, keylen, msglen, bits, step)\
+	(libkeccak_spec_shake(&spec, semicapacity, output),\
+	 test_hmac_case("SHAKE"#semicapacity"("#output")", &spec, LIBKECCAK_SHAKE_SUFFIX,\
+	                key, keylen, msg, msglen, bits, step, answer))
+
+	struct libkeccak_spec spec;
+	char key[1000], msg[1000];
+	const char *answer;
+	size_t i;
+
+	printf("Testing HMAC:\n");
+
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = (char)i;
+	for (i = 0; i < sizeof(msg); i++)
+		msg[i] = (char)(i % 251);
+
+	answer = "315272f9905ce7949b5613676bcc0dbf6a2e64af50eb9cb6175b1251";
+	if (hmac(224, 224, 34, 0, 0))
+		return -1;
+	answer = "5b346a81b2afa64f87c507dbf024e9a38ec781e5aa459552d0f3267c6281d673";
+	if (hmac(256, 256, 34, 0, 0) || hmac(256, 256, 34, 0, 5))
+		return -1;
+	answer = "ae26e823940a8fc7c3f11d0c49d3435a63381ec9b137773943979aa6faaaef21"
+	         "7bd79db606c9b19590ef58168c3e169d";
+	if (hmac(384, 384, 34, 0, 1))
+		return -1;
+	answer = "f8fca7c705bdd7912a7574659c59a75abaa89a736ad86b8c78b29018454b1118"
+	         "4b8936f4948d236385bde12e539d52118c8b7b2763844e7529e98613bed087b8";
+	if (hmac(512, 512, 34, 0, 0))
+		return -1;
+	answer = "43f48a3fc804652bbd31b36472e432cdba28bdb61b995fe98e0fd59fb98aa8c7";
+	if (hmac(256, 63, 5, 0, 0))
+		return -1;
+	answer = "1b9044e0d5bb4ef944bc00f1b26c483ac3e222f4640935d089a49083";
+	if (hmac(224, 0, 0, 0, 0))
+		return -1;
+	answer = "3a18da1112b96ab0dac26a3b6913901dfc4a32d24d331e7034ff8b075a2d89de"
+	         "371bd0171fd98c5ebeff6632845081cdb80e13e19a4ec1260969bb8b12caf51c";
+	if (hmac(512, 1600, 128, 0, 0) || hmac(512, 1600, 128, 0, 72))
+		return -1;
+	answer = "b4832d83b567baffa0d0f0a4032565565728a2dd21233a76be3f0d37311e98bc";
+	if (hmac(256, 1091, 300, 0, 0) || hmac(256, 1091, 300, 0, 1) || hmac(256, 1091, 300, 0, 137) ||
+	    hmac(256, 1091, 300, 0, 9) || hmac(256, 1091, 300, 0, 300))
+		return -1;
+	answer = "942746f7ea36c87d0da60dbc1a968dda9e50a4e159553564fa6a1ce9a7e75d7c";
+	if (hmac(256, 1091, 300, 3, 0) || hmac(256, 1091, 300, 3, 7))
+		return -1;
+	answer = "a5797924b355eda430f5ad6dc7b0cdd1a5a3b852192b79e8e799d1775895a2fa"
+	         "54371ef3e4a72dbc3fae2efd7079b38bae84359334ef4328cff86f17f6e50fdd";
+	if (hmac(512, 4805, 999, 5, 0) || hmac(512, 4805, 999, 5, 100))
+		return -1;
+
+	answer = "d5a9235205f8807774113607dc680b2a23ba2d86e8a802962f278061eb61933e"
+	         "5db2dcb22bd58e1e5d60682a8db4d4a3a4c0d5ebf54a69fd171e835cefc3265b"
+	         "34e868083ef26f9dcae28da22e26c0bb3eb9ac42e5c69abf076c4b11e8154512"
+	         "828f97a7720a2b32d257cfc3179d7dfbb2f11c3e722bd3d18be79f4f807e5aa7"
+	         "e19a8882c99d5b39b439c40a9e005fe9b412a2be7210aff65a923bc971e4726f"
+	         "7042d74fb761879fb502a58416801e7389f04b581f7f6bf602a15493b1b346f7"
+	         "5ec194d761391fb0017fdf36d90bb7c2108c68c16452b9032a7f4961cbfe3a33"
+	         "5cbb15b56fa25566912f5adc803d3a85ac4423c89833b846cd77";
+	if (hmac_shake(256, 2000, 256, 100, 0, 0))
+		return -1;
+	answer = "21ffacc5f4b27eba0e2d9791ef4b2fa520cae8bf6efa9a3da644eb3fe2ac88c5"
+	         "eefefda14b2c3776e0d98d418ab30c76ea2f77a83c57ce9f35aeabc275b50b84"
+	         "ed4829ab72734b8ed453165dbd2dae9fbf78084b877026bbb24169ba62fce23e"
+	         "bb35f46cfa6326be454c9718d2275a8bf449cef09099f6bf6fae8ba5846ecb36"
+	         "8051f63ad38b1152f4d4e9a35ce7ac2424d229598027ebf4a8af32a1bc0e2423"
+	         "b3a04f1df34a90848d1f75e77593313501c9d6507579d51cc15f4c34cfcc07f4"
+	         "00071f9f36faef27dd098e70041b73b4c8633292d4a63b990a4442c713dc3f48"
+	         "d5fc53e1ae769a4bbc9628d1acc8c5320ede1c9eea3a2c14abeb07";
+	if (hmac_shake(256, 2003, 1091, 300, 3, 0) || hmac_shake(256, 2003, 1091, 300, 3, 11))
+		return -1;
+	answer = "7d34af08951af9f64e9967c6789bf1100f92009d6af8d5e99548c12673da330f"
+	         "c7198a6382823b27d177618ce19c2e448a1be9421a8a94c45b761a7af26f165e"
+	         "cdcd65c21cda41fc17c9e12cc917257ec631947f6b469233776227fff311e6f5"
+	         "36e48c82320c0db04b5fb226ce65dc72c1c42bf7acfa20c2dd3ff33da8a2acc1"
+	         "4d66c534c739e0f3";
+	if (hmac_shake(256, 1088, 256, 10, 0, 0))
+		return -1;
+
+	printf("\n");
+	return 0;
+
+#undef hmac
+#undef hmac_shake
+}
 
 /**
  * Run a test for `libkeccak_generalised_sum_fd`
@@ -1292,8 +3117,17 @@ main(void)
 	    test_digest() ||
 	    test_digest_bits() ||
 	    test_digest_trunc() ||
+	    test_digest_rounds() ||
 	    test_update() ||
-	    test_squeeze())
+	    test_update_chunked() ||
+	    test_squeeze() ||
+	    test_digest_many() ||
+	    test_digest_pair() ||
+	    test_job_manager() ||
+	    test_state_batch() ||
+	    test_k12() ||
+	    test_parallelhash() ||
+	    test_kmac() || test_tuplehash() || test_cshake_prefix() || test_hmac())
 		return 1;
 
 	if (test_file(&spec, LIBKECCAK_SHA3_SUFFIX, ".testfile",
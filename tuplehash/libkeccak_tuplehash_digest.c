@@ -0,0 +1,29 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_RIGHT_ENCODE 1
+#include "../common.h"
+
+
+/**
+ * Absorb the last fields of a tuple and
+ * squeeze the TupleHash hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   fields   The fields, may be `NULL` if `nfields` is 0
+ * @param   nfields  The number of elements in `fields`
+ * @param   xof      Non-zero for TupleHashXOF, where the output
+ *                   does not depend on the output size
+ * @param   hashsum  Output parameter for the hashsum, may be `NULL`
+ * @return           Zero on success, -1 on error
+ */
+int
+libkeccak_tuplehash_digest(struct libkeccak_state *restrict state, const struct libkeccak_tuple_field *restrict fields,
+                           size_t nfields, int xof, void *restrict hashsum)
+{
+	unsigned char encoded[sizeof(uintmax_t) + 1];
+	size_t n;
+
+	libkeccak_tuplehash_update(state, fields, nfields);
+	n = right_encode(encoded, xof ? 0 : (uintmax_t)state->n);
+	return libkeccak_digest(state, encoded, n, 0,
+	                        libkeccak_cshake_suffix(sizeof(TUPLEHASH_FUNCTION_NAME) - 1, 0), hashsum);
+}
@@ -0,0 +1,33 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Initialise a state for TupleHash (TupleHash128 or
+ * TupleHash256, or the XOF variants) hashing
+ * 
+ * @param   state         The state that should be initialised
+ * @param   semicapacity  The value of x in `TupleHashx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @return                Zero on success, -1 on error
+ */
+int
+libkeccak_tuplehash_initialise(struct libkeccak_state *restrict state, long int semicapacity, long int output,
+                               const void *restrict custom, size_t customlen)
+{
+	struct libkeccak_spec spec;
+
+	if ((semicapacity != 128 && semicapacity != 256) || output <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	libkeccak_spec_cshake(&spec, semicapacity, output);
+	if (libkeccak_state_initialise(state, &spec) < 0)
+		return -1;
+	libkeccak_cshake_initialise(state, TUPLEHASH_FUNCTION_NAME, sizeof(TUPLEHASH_FUNCTION_NAME) - 1, 0, NULL,
+	                            custom, customlen, 0, NULL);
+	return 0;
+}
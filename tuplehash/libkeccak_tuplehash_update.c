@@ -0,0 +1,31 @@
+/* See LICENSE file for copyright and license details. */
+#define NEED_LEFT_ENCODE 1
+#include "../common.h"
+
+
+/**
+ * Absorb fields of a tuple to a TupleHash hashing state
+ * 
+ * @param   state    The hashing state
+ * @param   fields   The fields, may be `NULL` if `nfields` is 0
+ * @param   nfields  The number of elements in `fields`
+ * @return           Zero on success, -1 on error
+ */
+int
+libkeccak_tuplehash_update(struct libkeccak_state *restrict state, const struct libkeccak_tuple_field *restrict fields,
+                           size_t nfields)
+{
+	unsigned char encoded[sizeof(uintmax_t) + 1];
+	size_t i, n;
+
+	/* encode_string(field) = left_encode(bitlen(field)) || field,
+	 * the field is absorbed directly from the caller's memory */
+	for (i = 0; i < nfields; i++) {
+		n = left_encode(encoded, (uintmax_t)fields[i].len * 8);
+		libkeccak_update(state, encoded, n);
+		if (fields[i].len)
+			libkeccak_update(state, fields[i].data, fields[i].len);
+	}
+
+	return 0;
+}
@@ -0,0 +1,6 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+extern inline int libkeccak_cshakesum_fd(int, struct libkeccak_state *restrict, const struct libkeccak_cshake_prefix *restrict,
+                                         void *restrict);
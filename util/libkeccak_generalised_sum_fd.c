@@ -28,15 +28,12 @@ libkeccak_generalised_sum_fd(int fd, struct libkeccak_state *restrict state, con
 #endif
 	size_t blksize = 4096;
 	unsigned char *restrict chunk;
-	size_t chunksize, extrasize, extrachunks;
-	size_t chunks, chunkmod;
+	size_t chunksize, chunkmod;
 
 	if (spec && libkeccak_state_initialise(state, spec) < 0)
 		return -1;
 
 	chunksize = libkeccak_zerocopy_chunksize(state);
-	extrasize = ((suffix ? strlen(suffix) : 0) + 2 + 7) >> 3;
-	extrachunks = (extrasize + (chunksize - 1)) / chunksize;
 
 #ifndef _WIN32
 	if (fstat(fd, &attr) == 0)
@@ -44,15 +41,11 @@ libkeccak_generalised_sum_fd(int fd, struct libkeccak_state *restrict state, con
 			blksize = (size_t)attr.st_blksize;
 #endif
 
-	chunks = blksize / chunksize;
 	chunkmod = blksize % chunksize;
 	if (chunkmod) {
 		blksize -= chunkmod;
 		blksize += chunksize;
-		chunks += 1;
 	}
-	if (chunks < extrachunks + 1)
-		blksize = (extrachunks + 1) * chunksize;
 
 #if ALLOCA_LIMIT > 0
 	if (blksize > (size_t)ALLOCA_LIMIT) {
@@ -94,14 +87,10 @@ libkeccak_generalised_sum_fd(int fd, struct libkeccak_state *restrict state, con
 		}
 	}
 
-	if (extrasize > blksize - offset) {
-		chunkmod = offset % chunksize;
-		libkeccak_zerocopy_update(state, chunk, offset - chunkmod);
-		__builtin_memcpy(chunk, &chunk[offset - chunkmod], chunkmod * sizeof(char));
-		offset = chunkmod;
-	}
-
 	libkeccak_zerocopy_digest(state, chunk, offset, 0, suffix, hashsum);
+#if ALLOCA_LIMIT <= 0
+	free(chunk);
+#endif
 	return 0;
 
 fail:
@@ -0,0 +1,68 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+/**
+ * Calculate the KangarooTwelve hashsum of a file,
+ * the content of the file is assumed non-sensitive
+ * 
+ * @param   fd            The file descriptor of the file to hash
+ * @param   state         The hashing state, should not be initialised (memory leak otherwise)
+ * @param   semicapacity  The value of x in `KTx`, 128 or 256
+ * @param   output        The output size, in bits
+ * @param   pool          Worker pool used to hash the leaves, may be `NULL`
+ * @param   custom        The customisation string, may be `NULL` if `customlen` is 0
+ * @param   customlen     The length of the customisation string, in bytes
+ * @param   hashsum       Output array for the hashsum, have an allocation size of
+ *                        at least `((output + 7) / 8) * sizeof(char)`, may be `NULL`
+ * @return                Zero on success, -1 on error
+ */
+int
+libkeccak_k12sum_fd(int fd, struct libkeccak_k12_state *restrict state, long int semicapacity, long int output,
+                    struct libkeccak_worker_pool *pool, const void *restrict custom, size_t customlen,
+                    void *restrict hashsum)
+{
+	ssize_t got;
+	size_t offset, size, blksize;
+	unsigned char *restrict chunk;
+
+	if (libkeccak_k12_initialise(state, semicapacity, output, pool) < 0)
+		return -1;
+
+	/* The first chunk is read by itself so that the following
+	 * reads fill whole batches of leaves, which are then hashed
+	 * directly from `chunk` rather than copied to `state->buffer` */
+	size = state->capacity * LIBKECCAK_K12_CHUNK_SIZE;
+	chunk = malloc(size);
+	if (!chunk)
+		return -1;
+	blksize = LIBKECCAK_K12_CHUNK_SIZE;
+
+	offset = 0;
+	for (;;) {
+		got = read(fd, &chunk[offset], blksize - offset);
+		if (got <= 0) {
+			if (!got)
+				break;
+			if (errno == EINTR)
+				continue;
+			goto fail;
+		}
+		offset += (size_t)got;
+		if (offset == blksize) {
+			if (libkeccak_k12_update(state, chunk, blksize) < 0)
+				goto fail;
+			blksize = size;
+			offset = 0;
+		}
+	}
+
+	if (libkeccak_k12_digest(state, chunk, offset, custom, customlen, hashsum) < 0)
+		goto fail;
+	free(chunk);
+	return 0;
+
+fail:
+	free(chunk);
+	return -1;
+}
@@ -0,0 +1,5 @@
+/* See LICENSE file for copyright and license details. */
+#include "../common.h"
+
+
+extern inline int libkeccak_turboshakesum_fd(int, struct libkeccak_state *restrict, long, long, void *restrict);